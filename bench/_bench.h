@@ -0,0 +1,317 @@
+#pragma once
+
+#include <string.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nanobench.h>
+
+namespace force_ambiguity {
+struct dummy {};
+typedef dummy size_t;
+typedef dummy ptrdiff_t;
+typedef dummy int8_t;
+typedef dummy int16_t;
+typedef dummy int32_t;
+typedef dummy int64_t;
+typedef dummy uint8_t;
+typedef dummy uint16_t;
+typedef dummy uint32_t;
+typedef dummy uint64_t;
+} // namespace force_ambiguity
+
+using namespace force_ambiguity;
+
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/string.h>
+#include <saco/thread_cache.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct saco_foo {
+	std::size_t n;
+	int* p;
+	std::string_view sv1;
+	std::string_view sv2;
+};
+
+template <>
+struct saco::builder<saco_foo> {
+	template <class Context, class... Args>
+	static saco_foo* build(void* memory, Context& ctx, std::size_t n, std::string_view sv1, std::string_view sv2) {
+		[[maybe_unused]] auto const s1 = saco::place_string_view(ctx, sv1);
+		[[maybe_unused]] auto const s2 = saco::place_string_view(ctx, sv2);
+		[[maybe_unused]] int* const p = saco::place<int[]>(n, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) saco_foo{n, p, s1, s2};
+		else
+			return nullptr;
+	}
+};
+
+struct classic_foo {
+	classic_foo(std::size_t n, std::string_view sv1, std::string_view sv2) :
+			n(n),
+			p(n ? std::make_unique<int[]>(n) : nullptr),
+			s1(sv1),
+			s2(sv2) {
+	}
+
+	std::size_t n;
+	std::unique_ptr<int[]> p;
+	std::string s1;
+	std::string s2;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace bench {
+
+// Objects built per benchmark iteration, nanobench reports the time per object.
+inline constexpr std::size_t BATCH = 100;
+
+// Average length of the int array and of the strings of the objects.
+// "small" strings fit into the small string buffer of std::string, the others don't.
+struct object_size {
+	char const* name;
+	std::size_t array_length;
+	std::size_t string_length;
+};
+
+inline constexpr object_size SMALL{"small", 4, 10};
+inline constexpr object_size MEDIUM{"medium", 10, 30};
+inline constexpr object_size LARGE{"large", 100, 200};
+inline constexpr object_size OBJECT_SIZES[] = {SMALL, MEDIUM, LARGE};
+
+struct foo_args {
+	std::size_t n;
+	std::string_view s1;
+	std::string_view s2;
+};
+
+// Generates constructor arguments for saco_foo/classic_foo, either always the average lengths of `size` ("fixed") or
+// lengths drawn uniformly from [average / 2, average * 3 / 2] ("random"). Same seed, same sequence.
+class args_generator {
+public:
+	args_generator(object_size size, bool random, std::uint64_t seed = 12345) :
+			m_size{size},
+			m_random{random},
+			m_rng{seed},
+			m_chars(size.string_length * 3 / 2 + 1, 'x') {
+	}
+
+	foo_args next() {
+		return {length(m_size.array_length), string(), string()};
+	}
+
+private:
+	std::size_t length(std::size_t average) {
+		if (!m_random)
+			return average;
+		return average / 2 + m_rng.bounded(static_cast<std::uint32_t>(average + 1));
+	}
+
+	std::string_view string() {
+		return {m_chars.data(), length(m_size.string_length)};
+	}
+
+	object_size m_size;
+	bool m_random;
+	ankerl::nanobench::Rng m_rng;
+	std::string m_chars;
+};
+
+inline std::unique_ptr<classic_foo> make_unique_classic(foo_args const& a) {
+	return std::make_unique<classic_foo>(a.n, a.s1, a.s2);
+}
+
+inline std::shared_ptr<classic_foo> make_shared_classic(foo_args const& a) {
+	return std::make_shared<classic_foo>(a.n, a.s1, a.s2);
+}
+
+inline saco::unique_ptr<saco_foo> build_unique_saco(foo_args const& a) {
+	return saco::build_unique<saco_foo>(a.n, a.s1, a.s2);
+}
+
+inline std::shared_ptr<saco_foo> build_shared_saco(foo_args const& a) {
+	return saco::build_shared<saco_foo>(a.n, a.s1, a.s2);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Leaves the heap in a used state (many free blocks of mixed sizes), closer to a long running process than a fresh one.
+inline void fragment_heap() {
+	static constexpr std::size_t num_allocs = 1'000'000;
+	static constexpr std::uint32_t alloc_range = 8192;
+
+	std::vector<void*> allocs;
+	allocs.reserve(num_allocs);
+	ankerl::nanobench::Rng rng{42};
+	for (std::size_t i = 0; i < num_allocs; i++) {
+		std::uint32_t range = 8;
+		while (range * 2 <= alloc_range) {
+			if (rng.bounded(1024) < 512)
+				break;
+			range *= 2;
+		}
+
+		allocs.push_back(::operator new(rng.bounded(range)));
+	}
+
+	for (std::size_t i = 0; i < num_allocs; i++) {
+		auto const n = rng.bounded(num_allocs);
+		if (allocs[n])
+			::operator delete(allocs[n]);
+		allocs[n] = nullptr;
+	}
+}
+
+// Collects the results of all benchmarks of a target and writes them as nanobench JSON when done.
+// The output file is the first command line argument, `<target>.json` by default.
+class suite {
+public:
+	suite(int argc, char** argv, std::string const& name) : m_path{argc > 1 ? argv[1] : name + ".json"} {
+	}
+
+	suite(suite&&) = delete;
+
+	~suite() {
+		std::ofstream{m_path} << render();
+		std::cout << "results written to " << m_path << std::endl;
+		if (!m_metrics.empty()) {
+			std::string const path = metrics_path();
+			std::ofstream{path} << metrics_json();
+			std::cout << "metrics written to " << path << std::endl;
+		}
+	}
+
+	// A group of benchmarks, reported relative to the first one of the group.
+	ankerl::nanobench::Bench group(std::string const& title, std::size_t batch = BATCH) const {
+		ankerl::nanobench::Bench b;
+		b.title(title).batch(batch).unit("object").relative(true).warmup(100).minEpochIterations(100);
+		return b;
+	}
+
+	void add(ankerl::nanobench::Bench const& b) {
+		m_results.insert(m_results.end(), b.results().begin(), b.results().end());
+	}
+
+	// Records a value that nanobench doesn't measure itself (e.g. cache misses). The values are written to a separate
+	// file next to the results, `<output>.metrics.json` (without the `.json` of the output file).
+	void add_metric(std::string const& title, std::string const& name, std::string const& unit, double value) {
+		m_metrics.push_back({title, name, unit, value});
+	}
+
+private:
+	struct metric {
+		std::string title;
+		std::string name;
+		std::string unit;
+		double value;
+	};
+
+	std::string render() const {
+		std::ostringstream json;
+		ankerl::nanobench::render(ankerl::nanobench::templates::json(), m_results, json);
+		return json.str();
+	}
+
+	std::string metrics_path() const {
+		std::string_view const extension = ".json";
+		std::string_view base = m_path;
+		if (base.size() >= extension.size() && base.substr(base.size() - extension.size()) == extension)
+			base.remove_suffix(extension.size());
+		return std::string{base} + ".metrics.json";
+	}
+
+	static std::string json_string(std::string const& text) {
+		std::ostringstream json;
+		json << '"';
+		for (char const c : text) {
+			switch (c) {
+			case '"':
+				json << "\\\"";
+				break;
+			case '\\':
+				json << "\\\\";
+				break;
+			case '\n':
+				json << "\\n";
+				break;
+			case '\t':
+				json << "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+					json << escaped;
+				} else
+					json << c;
+			}
+		}
+		json << '"';
+		return json.str();
+	}
+
+	std::string metrics_json() const {
+		std::ostringstream json;
+		json << "{\n    \"metrics\": [\n";
+		for (std::size_t i = 0; i < m_metrics.size(); i++) {
+			metric const& m = m_metrics[i];
+			json << "        {\n";
+			json << "            \"title\": " << json_string(m.title) << ",\n";
+			json << "            \"name\": " << json_string(m.name) << ",\n";
+			json << "            \"unit\": " << json_string(m.unit) << ",\n";
+			json << "            \"value\": ";
+			if (std::isfinite(m.value))
+				json << m.value << "\n";
+			else
+				json << "null\n";
+			json << "        }" << (i + 1 < m_metrics.size() ? ",\n" : "\n");
+		}
+		json << "    ]\n}\n";
+		return json.str();
+	}
+
+	std::string m_path;
+	std::vector<ankerl::nanobench::Result> m_results;
+	std::vector<metric> m_metrics;
+};
+
+// Builds BATCH objects with `make(foo_args)` per iteration and destroys them at its end.
+template <class Make>
+SACO_NOINLINE void run_build(
+		ankerl::nanobench::Bench& b,
+		char const* name,
+		object_size size,
+		bool random,
+		Make const& make) {
+	std::vector<decltype(make(std::declval<foo_args>()))> objects;
+	objects.reserve(BATCH);
+	args_generator gen{size, random};
+	b.run(name, [&] {
+		for (std::size_t i = 0; i < BATCH; i++)
+			objects.push_back(make(gen.next()));
+		ankerl::nanobench::doNotOptimizeAway(objects.data());
+		objects.clear();
+	});
+}
+
+inline std::string group_title(char const* kind, object_size size, bool random) {
+	return std::string(kind) + " " + size.name + (random ? " random" : " fixed");
+}
+
+} // namespace bench
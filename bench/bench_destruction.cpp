@@ -0,0 +1,49 @@
+#include "_bench.h"
+
+// Destroying objects, without the cost of building them: each iteration destroys BATCH objects of a pool that is
+// built before the benchmark runs, in the order they were built.
+
+namespace {
+
+inline constexpr std::size_t EPOCHS = 11;
+inline constexpr std::size_t EPOCH_ITERATIONS = 100;
+
+template <class Make>
+SACO_NOINLINE void run_destruction(
+		ankerl::nanobench::Bench& b,
+		char const* name,
+		bench::object_size size,
+		bool random,
+		Make const& make) {
+	// nanobench calls the benchmark exactly EPOCHS * EPOCH_ITERATIONS times with these settings
+	std::size_t const pool_size = EPOCHS * EPOCH_ITERATIONS * bench::BATCH;
+	std::vector<decltype(make(std::declval<bench::foo_args>()))> pool;
+	pool.reserve(pool_size);
+	bench::args_generator gen{size, random};
+	for (std::size_t i = 0; i < pool_size; i++)
+		pool.push_back(make(gen.next()));
+
+	std::size_t next = 0;
+	b.run(name, [&] {
+		for (std::size_t i = 0; i < bench::BATCH && next < pool_size; i++)
+			pool[next++].reset();
+	});
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bench::fragment_heap();
+	bench::suite suite{argc, argv, "bench_destruction"};
+
+	for (bench::object_size const size : bench::OBJECT_SIZES)
+		for (bool const random : {false, true}) {
+			auto b = suite.group(bench::group_title("destruction", size, random));
+			b.warmup(0).epochs(EPOCHS).epochIterations(EPOCH_ITERATIONS);
+			run_destruction(b, "classic unique_ptr", size, random, bench::make_unique_classic);
+			run_destruction(b, "saco unique_ptr", size, random, bench::build_unique_saco);
+			run_destruction(b, "classic shared_ptr", size, random, bench::make_shared_classic);
+			run_destruction(b, "saco shared_ptr", size, random, bench::build_shared_saco);
+			suite.add(b);
+		}
+}
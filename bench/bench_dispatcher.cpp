@@ -0,0 +1,85 @@
+#include "_bench.h"
+
+#include <saco/xsize_dispatcher.h>
+
+// Dispatching a size to its size class, as build_shared does for every object (see shared_alloc_impl).
+// The nested-if dispatcher is a tree of comparisons, cheap when the branches are predictable, the switch and the
+// geometric dispatchers compute the bucket and jump through a table, which costs the same for every size distribution.
+
+namespace {
+
+inline constexpr std::size_t SIZE_COUNT = 4096;
+
+// largest size all dispatchers handle
+inline constexpr std::size_t MAX_SIZE = saco::detail::size_dispatcher_nested_if::MAX_SIZE;
+
+template <std::size_t BUCKET_SIZE>
+struct bucket_size_fn {
+	SACO_NOINLINE std::size_t operator()(std::size_t s) const {
+		return BUCKET_SIZE - s;
+	}
+};
+
+struct distribution {
+	char const* name;
+	std::vector<std::size_t> sizes;
+};
+
+std::vector<distribution> make_distributions() {
+	ankerl::nanobench::Rng rng{42};
+	std::vector<distribution> distributions;
+
+	// every size equally likely
+	distributions.push_back({"uniform", {}});
+	for (std::size_t i = 0; i < SIZE_COUNT; i++)
+		distributions.back().sizes.push_back(1 + rng.bounded(MAX_SIZE));
+
+	// half of the sizes up to 64, a quarter up to 128 and so on
+	distributions.push_back({"skewed", {}});
+	for (std::size_t i = 0; i < SIZE_COUNT; i++) {
+		std::uint32_t range = 64;
+		while (range * 2 <= MAX_SIZE && rng.bounded(2) == 0)
+			range *= 2;
+		distributions.back().sizes.push_back(1 + rng.bounded(range));
+	}
+
+	// always the same size, e.g. objects of a single type with fixed contents
+	distributions.push_back({"constant", std::vector<std::size_t>(SIZE_COUNT, 100)});
+
+	return distributions;
+}
+
+template <class Dispatcher>
+SACO_NOINLINE void run_dispatch(ankerl::nanobench::Bench& b, char const* name, std::vector<std::size_t> const& sizes) {
+	b.run(name, [&] {
+		std::size_t sum = 0;
+		for (std::size_t const s : sizes)
+			sum += Dispatcher::template dispatch<bucket_size_fn>(s, s);
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+SACO_NOINLINE void run_alloc(ankerl::nanobench::Bench& b, std::vector<std::size_t> const& sizes) {
+	b.run("shared_alloc_impl::alloc (configured)", [&] {
+		for (std::size_t const s : sizes)
+			ankerl::nanobench::doNotOptimizeAway(saco::detail::shared_alloc_impl::alloc(s));
+	});
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bench::suite suite{argc, argv, "bench_dispatcher"};
+	std::cout << "build_shared uses size_dispatcher_"
+			  << (SACO_SIZE_DISPATCHER == SACO_SIZE_DISPATCHER_SWITCH ? "switch" : "nested_if") << std::endl;
+
+	for (distribution const& d : make_distributions()) {
+		auto b = suite.group(std::string("dispatcher ") + d.name, SIZE_COUNT);
+		b.unit("size");
+		run_dispatch<saco::detail::size_dispatcher_nested_if>(b, "size_dispatcher_nested_if", d.sizes);
+		run_dispatch<saco::detail::size_dispatcher_switch>(b, "size_dispatcher_switch", d.sizes);
+		run_dispatch<saco::detail::size_dispatcher_geometric<2048>>(b, "size_dispatcher_geometric", d.sizes);
+		run_alloc(b, d.sizes);
+		suite.add(b);
+	}
+}
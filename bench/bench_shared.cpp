@@ -0,0 +1,46 @@
+#include "_bench.h"
+
+#include <saco/stats.h>
+
+// Building (and destroying) objects with build_shared vs. std::make_shared.
+
+namespace {
+
+// memory use of build_shared, recorded by the library when built with SACO_STATS
+void report_stats() {
+	for (bench::object_size const size : bench::OBJECT_SIZES) {
+		saco::reset_stats();
+		bench::args_generator gen{size, true};
+		for (std::size_t i = 0; i < 1000; i++)
+			bench::build_shared_saco(gen.next());
+
+		saco::build_stats const stats = saco::stats<saco_foo>();
+		std::cout << "build_shared<saco_foo> " << size.name << " random, per object: block "
+				  << stats.block_bytes / stats.builds << " padding " << stats.padding_bytes / stats.builds << " slack "
+				  << stats.slack_bytes() / stats.builds << std::endl;
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if SACO_IF_CONSTEXPR (saco::STATS_ENABLED)
+		report_stats();
+
+	bench::fragment_heap();
+	bench::suite suite{argc, argv, "bench_shared"};
+
+	for (bench::object_size const size : bench::OBJECT_SIZES)
+		for (bool const random : {false, true}) {
+			auto b = suite.group(bench::group_title("shared", size, random));
+			bench::run_build(b, "classic make_shared", size, random, bench::make_shared_classic);
+			bench::run_build(b, "saco shared-from-unique", size, random, [](bench::foo_args const& a) {
+				return std::shared_ptr<saco_foo>(bench::build_unique_saco(a));
+			});
+			bench::run_build(b, "saco build_shared", size, random, bench::build_shared_saco);
+			bench::run_build(b, "saco build_shared_cached", size, random, [](bench::foo_args const& a) {
+				return saco::build_shared_cached<saco_foo>(a.n, a.s1, a.s2);
+			});
+			suite.add(b);
+		}
+}
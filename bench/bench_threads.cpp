@@ -0,0 +1,132 @@
+#include "_bench.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Objects built on N producer threads and destroyed on M consumer threads. Every object is freed on another thread
+// than the one that allocated it, which is where allocators contend the most. Classic objects free 3 to 4 blocks each
+// (object, array, strings that don't fit the small string buffer), saco objects a single one.
+
+namespace {
+
+inline constexpr std::size_t OBJECTS_PER_PRODUCER = 50'000;
+
+// Objects are handed over in chunks, so the queue itself doesn't dominate.
+inline constexpr std::size_t CHUNK_SIZE = 64;
+
+template <class Ptr>
+class chunk_queue {
+public:
+	void push(std::vector<Ptr> chunk) {
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_chunks.push_back(std::move(chunk));
+		}
+		m_cv.notify_one();
+	}
+
+	void close() {
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_closed = true;
+		}
+		m_cv.notify_all();
+	}
+
+	// empty chunk once the queue is closed and drained
+	std::vector<Ptr> pop() {
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_cv.wait(lock, [this] { return m_closed || !m_chunks.empty(); });
+		if (m_chunks.empty())
+			return {};
+		std::vector<Ptr> chunk = std::move(m_chunks.front());
+		m_chunks.pop_front();
+		return chunk;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::deque<std::vector<Ptr>> m_chunks;
+	bool m_closed{false};
+};
+
+template <class Make>
+void produce_consume(std::size_t producers, std::size_t consumers, bench::object_size size, Make const& make) {
+	using ptr = decltype(make(std::declval<bench::foo_args>()));
+	chunk_queue<ptr> queue;
+
+	std::vector<std::thread> consumer_threads;
+	for (std::size_t c = 0; c < consumers; c++)
+		consumer_threads.emplace_back([&queue] {
+			while (!queue.pop().empty()) {
+				// the chunk and all its objects are destroyed here
+			}
+		});
+
+	std::vector<std::thread> producer_threads;
+	for (std::size_t p = 0; p < producers; p++)
+		producer_threads.emplace_back([&queue, &make, size, p] {
+			bench::args_generator gen{size, true, 12345 + p};
+			std::vector<ptr> chunk;
+			chunk.reserve(CHUNK_SIZE);
+			for (std::size_t i = 0; i < OBJECTS_PER_PRODUCER; i++) {
+				chunk.push_back(make(gen.next()));
+				if (chunk.size() == CHUNK_SIZE) {
+					queue.push(std::move(chunk));
+					chunk = std::vector<ptr>();
+					chunk.reserve(CHUNK_SIZE);
+				}
+			}
+			if (!chunk.empty())
+				queue.push(std::move(chunk));
+		});
+
+	for (auto& t : producer_threads)
+		t.join();
+	queue.close();
+	for (auto& t : consumer_threads)
+		t.join();
+}
+
+template <class Make>
+SACO_NOINLINE void run_threads(
+		ankerl::nanobench::Bench& b,
+		char const* name,
+		std::size_t producers,
+		std::size_t consumers,
+		bench::object_size size,
+		Make const& make) {
+	b.run(name, [&] { produce_consume(producers, consumers, size, make); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bench::suite suite{argc, argv, "bench_threads"};
+
+	std::size_t const cores = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+	std::vector<std::pair<std::size_t, std::size_t>> configurations{{1, 1}, {2, 2}, {4, 1}, {1, 4}};
+	if (cores > 8)
+		configurations.emplace_back(cores / 2, cores / 2);
+
+	for (bench::object_size const size : {bench::SMALL, bench::MEDIUM, bench::LARGE})
+		for (auto const& [producers, consumers] : configurations) {
+			std::string const title = std::string("threads ") + size.name + " " + std::to_string(producers) +
+					" producers " + std::to_string(consumers) + " consumers";
+			auto b = suite.group(title, producers * OBJECTS_PER_PRODUCER);
+			b.warmup(1).epochs(5).epochIterations(1).minEpochIterations(1);
+
+			run_threads(b, "classic make_unique", producers, consumers, size, bench::make_unique_classic);
+			run_threads(b, "saco build_unique", producers, consumers, size, bench::build_unique_saco);
+			run_threads(b, "saco build_unique_cached", producers, consumers, size, [](bench::foo_args const& a) {
+				return saco::build_unique_cached<saco_foo>(a.n, a.s1, a.s2);
+			});
+			run_threads(b, "classic make_shared", producers, consumers, size, bench::make_shared_classic);
+			run_threads(b, "saco build_shared", producers, consumers, size, bench::build_shared_saco);
+			suite.add(b);
+		}
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "_bench.h"
+
+// Reading objects after they have been built: sums the int arrays and the characters of the strings of all objects.
+// Shows the cost of the pointer chasing and cache misses of the classic layout vs. the single block of saco objects.
+//
+// The objects are built with unrelated allocations in between (as in a real program, where other data is allocated
+// at the same time), so the parts of a classic object don't end up next to each other by accident.
+// Where perf_event_open is available, the last level cache misses of one traversal are reported as well, and written to
+// the metrics file next to the JSON output.
+
+namespace {
+
+// objects per traversal, fewer for large objects to keep the memory use reasonable
+std::size_t object_count(bench::object_size size) {
+	std::size_t const approximate_size = 64 + size.array_length * sizeof(int) + 2 * size.string_length;
+	return std::min<std::size_t>(1'000'000, (std::size_t{256} << 20) / approximate_size);
+}
+
+std::size_t checksum(classic_foo const& f) {
+	std::size_t sum = f.n;
+	for (std::size_t i = 0; i < f.n; i++)
+		sum += static_cast<std::size_t>(f.p[i]);
+	for (char const c : f.s1)
+		sum += static_cast<unsigned char>(c);
+	for (char const c : f.s2)
+		sum += static_cast<unsigned char>(c);
+	return sum;
+}
+
+std::size_t checksum(saco_foo const& f) {
+	std::size_t sum = f.n;
+	for (std::size_t i = 0; i < f.n; i++)
+		sum += static_cast<std::size_t>(f.p[i]);
+	for (char const c : f.sv1)
+		sum += static_cast<unsigned char>(c);
+	for (char const c : f.sv2)
+		sum += static_cast<unsigned char>(c);
+	return sum;
+}
+
+template <class Ptr>
+SACO_NOINLINE std::size_t traverse(std::vector<Ptr> const& objects) {
+	std::size_t sum = 0;
+	for (auto const& object : objects)
+		sum += checksum(*object);
+	return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Counts last level cache read misses of the calling thread, if the kernel and the hardware allow it.
+class llc_miss_counter {
+public:
+	llc_miss_counter(llc_miss_counter&&) = delete;
+
+	llc_miss_counter() {
+#if defined(__linux__)
+		perf_event_attr attr{};
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+				(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+
+	~llc_miss_counter() {
+#if defined(__linux__)
+		if (m_fd >= 0)
+			::close(m_fd);
+#endif
+	}
+
+	bool available() const {
+		return m_fd >= 0;
+	}
+
+	// Misses while running `fn`, 0 if not available.
+	template <class Fn>
+	std::uint64_t count(Fn const& fn) {
+		std::uint64_t misses = 0;
+#if defined(__linux__)
+		if (m_fd >= 0) {
+			::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+			::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			fn();
+			::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (::read(m_fd, &misses, sizeof(misses)) != sizeof(misses))
+				misses = 0;
+			return misses;
+		}
+#endif
+		fn();
+		return misses;
+	}
+
+private:
+	int m_fd{-1};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Make>
+SACO_NOINLINE void run_traversal(
+		ankerl::nanobench::Bench& b,
+		bench::suite& suite,
+		llc_miss_counter& llc,
+		char const* name,
+		bench::object_size size,
+		Make const& make) {
+	std::size_t const count = object_count(size);
+	std::vector<decltype(make(std::declval<bench::foo_args>()))> objects;
+	objects.reserve(count);
+	std::vector<void*> unrelated;
+	unrelated.reserve(count);
+
+	bench::args_generator gen{size, true};
+	ankerl::nanobench::Rng rng{4711};
+	for (std::size_t i = 0; i < count; i++) {
+		objects.push_back(make(gen.next()));
+		unrelated.push_back(::operator new(16 + rng.bounded(240)));
+	}
+
+	b.run(name, [&] { ankerl::nanobench::doNotOptimizeAway(traverse(objects)); });
+
+	if (llc.available()) {
+		std::uint64_t const misses = llc.count([&] { ankerl::nanobench::doNotOptimizeAway(traverse(objects)); });
+		double const misses_per_object = static_cast<double>(misses) / static_cast<double>(count);
+		std::cout << "LLC misses/object " << size.name << " `" << name << "`: " << misses_per_object << std::endl;
+		suite.add_metric(b.title(), name, "LLC misses/object", misses_per_object);
+	}
+
+	objects.clear();
+	for (void* const p : unrelated)
+		::operator delete(p);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bench::fragment_heap();
+	bench::suite suite{argc, argv, "bench_traversal"};
+
+	llc_miss_counter llc;
+	if (!llc.available())
+		std::cout << "LLC miss counter not available (perf_event_open), reporting times only" << std::endl;
+
+	for (bench::object_size const size : bench::OBJECT_SIZES) {
+		auto b = suite.group(bench::group_title("traversal", size, true), object_count(size));
+		b.warmup(1).epochs(5).epochIterations(1).minEpochIterations(1);
+		run_traversal(b, suite, llc, "classic make_unique", size, bench::make_unique_classic);
+		run_traversal(b, suite, llc, "saco build_unique", size, bench::build_unique_saco);
+		run_traversal(b, suite, llc, "saco build_shared", size, bench::build_shared_saco);
+		suite.add(b);
+	}
+}
@@ -0,0 +1,19 @@
+#include "_bench.h"
+
+// Building (and destroying) objects with build_unique vs. std::make_unique.
+
+int main(int argc, char** argv) {
+	bench::fragment_heap();
+	bench::suite suite{argc, argv, "bench_unique"};
+
+	for (bench::object_size const size : bench::OBJECT_SIZES)
+		for (bool const random : {false, true}) {
+			auto b = suite.group(bench::group_title("unique", size, random));
+			bench::run_build(b, "classic make_unique", size, random, bench::make_unique_classic);
+			bench::run_build(b, "saco build_unique", size, random, bench::build_unique_saco);
+			bench::run_build(b, "saco build_unique_cached", size, random, [](bench::foo_args const& a) {
+				return saco::build_unique_cached<saco_foo>(a.n, a.s1, a.s2);
+			});
+			suite.add(b);
+		}
+}
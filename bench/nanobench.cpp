@@ -1,2 +1,2 @@
-#define ANKERL_NANOBENCH_IMPLEMENT
-#include <nanobench.h>
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include <nanobench.h>
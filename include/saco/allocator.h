@@ -0,0 +1,187 @@
+#pragma once
+
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Allocators are rebound to this type so that the blocks they hand out are suitably aligned for the root object.
+// (Rebinding to `byte` would only guarantee an alignment of 1, e.g. with std::pmr::polymorphic_allocator.)
+template <std::size_t ALIGN>
+struct alignas(ALIGN) allocation_unit {
+	byte bytes[ALIGN];
+};
+
+template <class T>
+using root_allocation_unit = allocation_unit<root_alignment_v<T>>;
+
+template <class Alloc, class Unit>
+using unit_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Unit>;
+
+template <class Unit>
+SACO_ALWAYS_INLINE std::size_t allocation_units(std::size_t size) {
+	return (size + sizeof(Unit) - 1) / sizeof(Unit);
+}
+
+template <class Alloc>
+inline constexpr bool is_memory_resource_pointer_v = std::is_convertible_v<Alloc const&, std::pmr::memory_resource*>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class UnitAlloc>
+class allocation_guard {
+	using traits = std::allocator_traits<UnitAlloc>;
+
+public:
+	allocation_guard(allocation_guard&&) = delete;
+
+	allocation_guard(UnitAlloc& alloc, std::size_t units) :
+			m_alloc{alloc},
+			m_memory{traits::allocate(alloc, units)},
+			m_units{units} {
+	}
+
+	~allocation_guard() {
+		if (m_memory)
+			traits::deallocate(m_alloc, m_memory, m_units);
+	}
+
+	void* get() const {
+		return m_memory;
+	}
+
+	void release() {
+		m_memory = nullptr;
+	}
+
+private:
+	UnitAlloc& m_alloc;
+	typename traits::pointer m_memory;
+	std::size_t m_units;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Deleter for objects built with build_unique_with.
+// Remembers the allocator and the size of the block, so the block can be returned to where it came from.
+template <class T, class Alloc>
+class saco_allocator_delete {
+	using unit = detail::root_allocation_unit<T>;
+
+public:
+	using allocator_type = detail::unit_allocator<Alloc, unit>;
+
+private:
+	using traits = std::allocator_traits<allocator_type>;
+	static_assert(std::is_same_v<typename traits::pointer, unit*>, "fancy pointers are not supported");
+
+public:
+	saco_allocator_delete(allocator_type alloc, std::size_t units) : m_alloc{std::move(alloc)}, m_units{units} {
+	}
+
+	void operator()(T* p) {
+		static_assert(sizeof(T) > 0, "type must be complete");
+		p->~T();
+		traits::deallocate(m_alloc, static_cast<unit*>(static_cast<void*>(p)), m_units);
+	}
+
+	allocator_type const& get_allocator() const {
+		return m_alloc;
+	}
+
+	std::size_t size() const {
+		return m_units * sizeof(unit);
+	}
+
+private:
+	allocator_type m_alloc;
+	std::size_t m_units;
+};
+
+template <class T, class Alloc>
+using allocator_unique_ptr = std::unique_ptr<T, saco_allocator_delete<T, Alloc>>;
+
+namespace pmr {
+
+template <class T>
+using unique_ptr = allocator_unique_ptr<T, std::pmr::polymorphic_allocator<byte>>;
+
+} // namespace pmr
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, class Alloc, class... Args, SACO_REQUIRES(!detail::is_memory_resource_pointer_v<Alloc>)>
+allocator_unique_ptr<T, Alloc> build_unique_with(Alloc const& alloc, Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	using deleter = saco_allocator_delete<T, Alloc>;
+
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+	std::size_t const required_size = mctx.required_size();
+	std::size_t const units = detail::allocation_units<detail::root_allocation_unit<T>>(required_size);
+
+	// allocate raw memory
+	typename deleter::allocator_type unit_alloc(alloc);
+	detail::allocation_guard<typename deleter::allocator_type> raw_memory{unit_alloc, units};
+
+	// construct
+	construct_context cctx{raw_memory.get(), required_size};
+	T* const obj = saco::place<T>(cctx, std::forward<Args>(args)...);
+	SACO_ASSERT(obj == raw_memory.get());
+	raw_memory.release();
+	detail::record_build<T>(required_size, mctx.padding_size(), units * sizeof(detail::root_allocation_unit<T>));
+	return allocator_unique_ptr<T, Alloc>(obj, deleter{std::move(unit_alloc), units});
+}
+
+template <class T, class... Args>
+pmr::unique_ptr<T> build_unique_with(std::pmr::memory_resource* resource, Args&&... args) {
+	return build_unique_with<T>(std::pmr::polymorphic_allocator<byte>{resource}, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, class Alloc, class... Args, SACO_REQUIRES(!detail::is_memory_resource_pointer_v<Alloc>)>
+std::shared_ptr<T> build_shared_with(Alloc const& alloc, Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+
+	// check size limit & allocate memory
+	std::size_t const alloc_size = mctx.required_size();
+	if (alloc_size > detail::shared_alloc_impl::MAX_SIZE) {
+		// the control block is allocated separately, but still comes from `alloc`
+		auto up = build_unique_with<T>(alloc, std::forward<Args>(args)...);
+		auto const deleter = up.get_deleter();
+		return std::shared_ptr<T>(up.release(), deleter, alloc);
+	}
+	std::shared_ptr<detail::shared_buffer_header> sp = detail::shared_alloc_impl::alloc<ALIGN>(alloc_size, alloc);
+
+	// construct
+	auto obj = detail::construct_shared<T, construct_context>(std::move(sp), alloc_size, std::forward<Args>(args)...);
+	detail::record_shared_build<T>(alloc_size, mctx.padding_size());
+	return obj;
+}
+
+template <class T, class... Args>
+std::shared_ptr<T> build_shared_with(std::pmr::memory_resource* resource, Args&&... args) {
+	return build_shared_with<T>(std::pmr::polymorphic_allocator<byte>{resource}, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Places many saco objects into a chain of blocks and frees them in bulk.
+//
+// Each object is measured and constructed like with build_unique, but instead of getting its own allocation it is
+// bump-allocated from the current block. Objects that are not trivially destructible have a small destructor record
+// placed right behind them, all other objects cost nothing but their measured size.
+// Destructors run (in reverse order of construction) and blocks are freed when the arena is released or destroyed.
+class arena final {
+public:
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = 4096;
+
+	arena(arena&&) = delete;
+
+	explicit arena(std::size_t block_size = DEFAULT_BLOCK_SIZE) : m_block_size{block_size} {
+	}
+
+	~arena() {
+		release();
+	}
+
+	template <class T, class... Args>
+	T* build(Args&&... args) {
+		static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+		static constexpr bool needs_dtor = !std::is_trivially_destructible_v<T>;
+
+		// measure
+		measure_context mctx{ALIGN};
+		saco::place<T>(mctx, std::as_const(args)...);
+		std::size_t const object_size = mctx.required_size();
+		std::size_t const dtor_offset = detail::align<alignof(dtor_record)>(object_size);
+		std::size_t const chunk_size = needs_dtor ? dtor_offset + sizeof(dtor_record) : object_size;
+
+		// allocate from current block
+		void* const chunk = allocate<ALIGN>(chunk_size);
+
+		// construct
+		construct_context cctx{chunk, object_size};
+		T* const obj = saco::place<T>(cctx, std::forward<Args>(args)...);
+		SACO_ASSERT(obj == chunk);
+
+		if SACO_IF_CONSTEXPR (needs_dtor) {
+			void* const record = static_cast<byte*>(chunk) + dtor_offset;
+			m_dtors = ::new (record) dtor_record{m_dtors, obj, &detail::call_dtor<T>};
+		}
+
+		return obj;
+	}
+
+	// Destroys all objects built in this arena and frees all blocks.
+	void release() {
+		for (dtor_record* r = m_dtors; r; r = r->prev)
+			r->dtor_fn(r->object);
+		m_dtors = nullptr;
+
+		for (block_header* b = m_blocks; b;)
+			detail::free_raw(std::exchange(b, b->prev));
+		m_blocks = nullptr;
+		m_current = 0;
+		m_end = 0;
+	}
+
+	std::size_t block_size() const {
+		return m_block_size;
+	}
+
+	// Total number of bytes allocated for blocks, including block headers and unused space.
+	std::size_t capacity() const {
+		std::size_t total = 0;
+		for (block_header const* b = m_blocks; b; b = b->prev)
+			total += b->size;
+		return total;
+	}
+
+private:
+	struct block_header {
+		block_header* prev;
+		std::size_t size;
+	};
+
+	struct dtor_record {
+		dtor_record* prev;
+		void* object;
+		void (*dtor_fn)(void*);
+	};
+
+	static constexpr std::size_t BLOCK_HEADER_SIZE = detail::align<detail::MAX_NEW_ALIGNMENT>(sizeof(block_header));
+
+	template <std::size_t ALIGN>
+	void* allocate(std::size_t size) {
+		auto const address = detail::align<ALIGN>(m_current);
+		if (SACO_LIKELY(address + size <= m_end)) {
+			m_current = address + size;
+			return reinterpret_cast<void*>(address);
+		}
+		return allocate_slow<ALIGN>(size);
+	}
+
+	template <std::size_t ALIGN>
+	SACO_NOINLINE void* allocate_slow(std::size_t size) {
+		// blocks are only aligned to MAX_NEW_ALIGNMENT, over-aligned objects may need some padding in front
+		std::size_t const padded_size = size + (ALIGN - detail::MAX_NEW_ALIGNMENT);
+
+		if (padded_size > m_block_size / 4 && m_blocks) {
+			// don't waste the rest of the current block on a large object, give it a block of its own
+			block_header* const b = new_block(padded_size, m_blocks->prev);
+			m_blocks->prev = b;
+			auto const address = reinterpret_cast<std::uintptr_t>(b) + BLOCK_HEADER_SIZE;
+			return reinterpret_cast<void*>(detail::align<ALIGN>(address));
+		}
+
+		std::size_t const payload_size = padded_size > m_block_size ? padded_size : m_block_size;
+		m_blocks = new_block(payload_size, m_blocks);
+		m_current = reinterpret_cast<std::uintptr_t>(m_blocks) + BLOCK_HEADER_SIZE;
+		m_end = m_current + payload_size;
+		auto const address = detail::align_and_add<ALIGN>(m_current, size);
+		SACO_ASSERT(m_current <= m_end);
+		return reinterpret_cast<void*>(address);
+	}
+
+	static block_header* new_block(std::size_t payload_size, block_header* prev) {
+		std::size_t const size = BLOCK_HEADER_SIZE + payload_size;
+		return ::new (detail::alloc_raw(size)) block_header{prev, size};
+	}
+
+	std::size_t m_block_size;
+	block_header* m_blocks{nullptr};
+	dtor_record* m_dtors{nullptr};
+	std::uintptr_t m_current{0};
+	std::uintptr_t m_end{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
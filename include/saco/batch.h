@@ -0,0 +1,150 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Header of a block that holds a whole batch of objects, it counts the objects that have not been destroyed yet.
+struct batch_slab {
+	std::atomic<std::size_t> live;
+};
+
+template <std::size_t ALIGN>
+void release_batch_slab(batch_slab* slab, std::size_t count) {
+	if (slab->live.fetch_sub(count, std::memory_order_acq_rel) == count) {
+		slab->~batch_slab();
+		free_raw<ALIGN>(slab);
+	}
+}
+
+} // namespace detail
+
+template <class T>
+class batch_delete {
+public:
+	static constexpr std::size_t SLAB_ALIGNMENT = detail::root_alignment_v<T>;
+
+	batch_delete() = default;
+
+	explicit batch_delete(detail::batch_slab* slab) : m_slab{slab} {
+	}
+
+	void operator()(T* p) const {
+		static_assert(sizeof(T) > 0, "type must be complete");
+		p->~T();
+		detail::release_batch_slab<SLAB_ALIGNMENT>(m_slab, 1);
+	}
+
+private:
+	detail::batch_slab* m_slab{nullptr};
+};
+
+// Handle to an object of a batch. The objects of a batch share one block, which is freed with the last object.
+template <class T>
+using batch_unique_ptr = std::unique_ptr<T, batch_delete<T>>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Builds one object per element of `arg_tuples` into a single block. `place_one(ctx, element)` places one object.
+// All objects are measured in a single measure_context and constructed in a single construct_context, back to back.
+template <class T, class Range, class PlaceOne>
+std::vector<batch_unique_ptr<T>> build_batch(Range const& arg_tuples, PlaceOne const& place_one) {
+	static constexpr std::size_t ALIGN = batch_delete<T>::SLAB_ALIGNMENT;
+
+	// measure
+	measure_context mctx{ALIGN};
+	mctx.allocate_space<batch_slab>();
+	std::size_t count = 0;
+	for (auto const& args : arg_tuples) {
+		place_one(mctx, args);
+		count++;
+	}
+	std::size_t const required_size = mctx.required_size();
+
+	std::vector<batch_unique_ptr<T>> objects;
+	if (count == 0)
+		return objects;
+	objects.reserve(count);
+
+	// allocate raw memory
+	std::unique_ptr<void, aligned_raw_delete<ALIGN>> raw_memory(alloc_raw<ALIGN>(required_size));
+
+	// construct
+	construct_context cctx{raw_memory.get(), required_size};
+	auto const slab = ::new (cctx.allocate_space<batch_slab>()) batch_slab{{count}};
+	raw_memory.release();
+
+	try {
+		for (auto const& args : arg_tuples)
+			objects.emplace_back(place_one(cctx, args), batch_delete<T>{slab});
+	} catch (...) {
+		// drop the references of the objects that were not built, the built ones are released by `objects`
+		release_batch_slab<ALIGN>(slab, count - objects.size());
+		throw;
+	}
+
+	return objects;
+}
+
+} // namespace detail
+
+// Builds one object per tuple of constructor/builder arguments in `arg_tuples`, with a single allocation for all of
+// them. The objects are laid out back to back in the order of `arg_tuples`.
+template <class T, class Range>
+std::vector<batch_unique_ptr<T>> build_unique_batch(Range const& arg_tuples) {
+	return detail::build_batch<T>(arg_tuples, [](auto& ctx, auto const& args) {
+		return std::apply([&ctx](auto const&... a) { return saco::place<T>(ctx, a...); }, args);
+	});
+}
+
+// Builds `count` objects from the same arguments, with a single allocation for all of them.
+template <class T, class... Args>
+std::vector<batch_unique_ptr<T>> build_many(std::size_t count, Args const&... args) {
+	struct repeat {
+		struct iterator {
+			std::size_t remaining;
+
+			bool operator!=(iterator const& other) const {
+				return remaining != other.remaining;
+			}
+
+			iterator& operator++() {
+				remaining--;
+				return *this;
+			}
+
+			int operator*() const {
+				return 0;
+			}
+		};
+
+		iterator begin() const {
+			return {count};
+		}
+
+		iterator end() const {
+			return {0};
+		}
+
+		std::size_t count;
+	};
+
+	return detail::build_batch<T>(repeat{count}, [&args...](auto& ctx, int) { return saco::place<T>(ctx, args...); });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
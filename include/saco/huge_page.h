@@ -0,0 +1,136 @@
+#pragma once
+
+#include <saco/allocator.h>
+#include <saco/saco.h>
+
+#if defined(_WIN32)
+#error "saco/huge_page.h requires POSIX mmap"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Size of a (transparent) huge page on x86-64 and of the default huge page of arm64 with 4 KiB pages.
+inline constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+inline std::size_t page_size() {
+	static std::size_t const size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+inline std::size_t huge_mapping_size(std::size_t size) {
+	std::size_t const page = page_size();
+	return (size + page - 1) / page * page;
+}
+
+// Maps `size` bytes starting at a huge page boundary and asks the kernel to back them with transparent huge pages.
+// Only whole huge pages of the mapping can be backed by them, the rest of it uses normal pages.
+inline void* map_huge(std::size_t size) {
+	std::size_t const mapping_size = huge_mapping_size(size);
+
+	// map one huge page more than needed and trim the mapping to a huge page boundary
+	int const flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	void* const raw = ::mmap(nullptr, mapping_size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (raw == MAP_FAILED)
+		throw std::bad_alloc();
+
+	auto const begin = reinterpret_cast<std::uintptr_t>(raw);
+	auto const aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+	if (aligned != begin)
+		::munmap(raw, aligned - begin);
+	::munmap(reinterpret_cast<void*>(aligned + mapping_size), begin + HUGE_PAGE_SIZE - aligned);
+
+	void* const memory = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+	// only a hint, without transparent huge page support the memory is simply backed by normal pages
+	::madvise(memory, mapping_size, MADV_HUGEPAGE);
+#endif
+	return memory;
+}
+
+inline void unmap_huge(void* memory, std::size_t size) noexcept {
+	::munmap(memory, huge_mapping_size(size));
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Allocator for large, randomly accessed blocks (lookup tables, indexes, ...). Allocations of at least `threshold`
+// bytes are mapped at huge page boundaries and backed by transparent huge pages where available, which saves TLB
+// misses. Smaller allocations come from operator new.
+//
+// Use it with build_unique_with and build_shared_with, or with build_unique_huge.
+template <class T>
+class huge_page_allocator {
+public:
+	using value_type = T;
+
+	huge_page_allocator() = default;
+
+	explicit huge_page_allocator(std::size_t threshold) : m_threshold{threshold} {
+	}
+
+	template <class U>
+	huge_page_allocator(huge_page_allocator<U> const& other) : m_threshold{other.threshold()} {
+	}
+
+	T* allocate(std::size_t n) {
+		if (n > static_cast<std::size_t>(-1) / sizeof(T))
+			throw std::bad_array_new_length();
+		std::size_t const size = n * sizeof(T);
+		if (size >= m_threshold)
+			return static_cast<T*>(detail::map_huge(size));
+		return static_cast<T*>(::operator new(size, std::align_val_t{alignof(T)}));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept {
+		std::size_t const size = n * sizeof(T);
+		if (size >= m_threshold)
+			detail::unmap_huge(p, size);
+		else
+			::operator delete(p, size, std::align_val_t{alignof(T)});
+	}
+
+	std::size_t threshold() const {
+		return m_threshold;
+	}
+
+	template <class U>
+	bool operator==(huge_page_allocator<U> const& other) const {
+		return m_threshold == other.threshold();
+	}
+
+	template <class U>
+	bool operator!=(huge_page_allocator<U> const& other) const {
+		return m_threshold != other.threshold();
+	}
+
+private:
+	std::size_t m_threshold{detail::HUGE_PAGE_SIZE};
+};
+
+template <class T>
+using huge_page_unique_ptr = allocator_unique_ptr<T, huge_page_allocator<byte>>;
+
+// Like build_unique, but blocks of a huge page or more are backed by huge pages. Pass a huge_page_allocator to
+// build_unique_with for another threshold.
+template <class T, class... Args>
+huge_page_unique_ptr<T> build_unique_huge(Args&&... args) {
+	return build_unique_with<T>(huge_page_allocator<byte>{}, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
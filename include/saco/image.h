@@ -0,0 +1,220 @@
+#pragma once
+
+#include <saco/offset_ptr.h>
+#include <saco/saco.h>
+#include <saco/ximage.h>
+
+#if defined(_WIN32)
+#error "saco/image.h requires POSIX mmap"
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+[[noreturn]] inline SACO_NOINLINE void throw_errno(char const* what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+class file_descriptor final {
+public:
+	file_descriptor(file_descriptor&&) = delete;
+
+	explicit file_descriptor(int fd) : m_fd{fd} {
+	}
+
+	~file_descriptor() {
+		if (m_fd >= 0)
+			::close(m_fd);
+	}
+
+	int get() const {
+		return m_fd;
+	}
+
+	// closes the descriptor, reporting errors (which may be delayed write errors)
+	void close() {
+		if (::close(std::exchange(m_fd, -1)) != 0)
+			throw_errno("saco: close");
+	}
+
+private:
+	int m_fd;
+};
+
+inline void write_all(int fd, void const* data, std::size_t size) {
+	auto p = static_cast<char const*>(data);
+	while (size > 0) {
+		ssize_t const n = ::write(fd, p, size);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			throw_errno("saco: write");
+		}
+		p += n;
+		size -= static_cast<std::size_t>(n);
+	}
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Writes the block of a relocatable object to a file, which can later be mapped back with saco::map.
+// The file is written next to `path`, synced and then renamed, so readers never see a partially written image, not even
+// after a crash.
+template <class T>
+void save(T const& obj, std::size_t size, std::string const& path) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+
+	detail::image_header const header = detail::make_image_header<T>(&obj, size);
+	static constexpr std::size_t PADDING = detail::image_payload_offset_v<T> - sizeof(header);
+	char const padding[PADDING + 1] = {};
+
+	std::string const tmp_path = path + ".tmp";
+	detail::file_descriptor fd{::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+	if (fd.get() < 0)
+		detail::throw_errno("saco: open");
+
+	try {
+		detail::write_all(fd.get(), &header, sizeof(header));
+		detail::write_all(fd.get(), padding, PADDING);
+		detail::write_all(fd.get(), &obj, size);
+		// the data must be on disk before the rename is, otherwise a crash can leave an empty file under `path`
+		if (::fsync(fd.get()) != 0)
+			detail::throw_errno("saco: fsync");
+		fd.close();
+		if (::rename(tmp_path.c_str(), path.c_str()) != 0)
+			detail::throw_errno("saco: rename");
+	} catch (...) {
+		::unlink(tmp_path.c_str());
+		throw;
+	}
+}
+
+template <class T>
+void save(relocatable_ptr<T> const& obj, std::string const& path) {
+	SACO_ASSERT(obj);
+	saco::save(*obj, obj.get_deleter().size(), path);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Read-only handle to a relocatable object mapped from an image file. The object is used in place, without any
+// deserialization, and the file stays mapped as long as the handle lives. Mapped objects are never destroyed.
+template <class T>
+class mapped_ptr final {
+public:
+	mapped_ptr() = default;
+
+	mapped_ptr(mapped_ptr&& other) noexcept :
+			m_mapping{std::exchange(other.m_mapping, nullptr)},
+			m_mapping_size{std::exchange(other.m_mapping_size, 0)},
+			m_object{std::exchange(other.m_object, nullptr)},
+			m_size{std::exchange(other.m_size, 0)} {
+	}
+
+	mapped_ptr& operator=(mapped_ptr&& other) noexcept {
+		mapped_ptr(std::move(other)).swap(*this);
+		return *this;
+	}
+
+	~mapped_ptr() {
+		if (m_mapping)
+			::munmap(m_mapping, m_mapping_size);
+	}
+
+	void swap(mapped_ptr& other) noexcept {
+		std::swap(m_mapping, other.m_mapping);
+		std::swap(m_mapping_size, other.m_mapping_size);
+		std::swap(m_object, other.m_object);
+		std::swap(m_size, other.m_size);
+	}
+
+	T const* get() const {
+		return m_object;
+	}
+
+	T const* operator->() const {
+		return m_object;
+	}
+
+	T const& operator*() const {
+		return *m_object;
+	}
+
+	explicit operator bool() const {
+		return m_object != nullptr;
+	}
+
+	// Size of the object's block, without the image header.
+	std::size_t size() const {
+		return m_size;
+	}
+
+	// Takes ownership of a mapping that holds a valid image. Used by saco::map, not meant to be called directly.
+	static mapped_ptr adopt(void* mapping, std::size_t mapping_size, T const* object, std::size_t size) {
+		mapped_ptr ptr;
+		ptr.m_mapping = mapping;
+		ptr.m_mapping_size = mapping_size;
+		ptr.m_object = object;
+		ptr.m_size = size;
+		return ptr;
+	}
+
+private:
+	void* m_mapping{nullptr};
+	std::size_t m_mapping_size{0};
+	T const* m_object{nullptr};
+	std::size_t m_size{0};
+};
+
+// Maps an image written by saco::save. Throws std::system_error if the file cannot be mapped and std::runtime_error if
+// it does not hold an image of T. Verifying the checksum touches every page of the image, pass `verify_checksum =
+// false` for trusted files to only read the pages that are actually used.
+template <class T>
+mapped_ptr<T> map(std::string const& path, bool verify_checksum = true) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+
+	detail::file_descriptor fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+	if (fd.get() < 0)
+		detail::throw_errno("saco: open");
+
+	struct stat st;
+	if (::fstat(fd.get(), &st) != 0)
+		detail::throw_errno("saco: fstat");
+	auto const file_size = static_cast<std::size_t>(st.st_size);
+	if (file_size < sizeof(detail::image_header))
+		detail::throw_invalid_image("too small");
+
+	void* const mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+	if (mapping == MAP_FAILED)
+		detail::throw_errno("saco: mmap");
+
+	try {
+		detail::image_header const header = detail::check_image<T>(mapping, file_size, verify_checksum);
+		auto const obj = reinterpret_cast<T const*>(static_cast<byte const*>(mapping) + header.payload_offset);
+		return mapped_ptr<T>::adopt(mapping, file_size, obj, static_cast<std::size_t>(header.payload_size));
+	} catch (...) {
+		::munmap(mapping, file_size);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
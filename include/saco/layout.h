@@ -0,0 +1,221 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Size of the unit that place_isolated keeps objects apart by, the destructive interference size of the target.
+// Some targets (e.g. Apple M-series or with adjacent line prefetching) are better served by 128.
+#if !defined(SACO_CACHE_LINE_SIZE)
+#define SACO_CACHE_LINE_SIZE 64
+#endif
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Indices of As... ordered by descending alignment of their elements, keeping declaration order for equal alignments.
+template <class... As>
+constexpr std::array<std::size_t, sizeof...(As)> alignment_order() {
+	constexpr std::size_t alignments[] = {alignof(std::remove_extent_t<As>)..., 0};
+	std::array<std::size_t, sizeof...(As)> order{};
+	for (std::size_t i = 0; i < sizeof...(As); i++)
+		order[i] = i;
+	// insertion sort, stable
+	for (std::size_t i = 1; i < sizeof...(As); i++)
+		for (std::size_t j = i; j > 0 && alignments[order[j - 1]] < alignments[order[j]]; j--) {
+			std::size_t const tmp = order[j];
+			order[j] = order[j - 1];
+			order[j - 1] = tmp;
+		}
+	return order;
+}
+
+template <class... As, class Context, std::size_t... I>
+std::tuple<std::remove_extent_t<As>*...> place_sorted_impl(
+		Context& ctx,
+		std::array<std::size_t, sizeof...(As)> const& counts,
+		std::index_sequence<I...>) {
+	static constexpr auto ORDER = alignment_order<As...>();
+
+	std::tuple<std::remove_extent_t<As>*...> result{};
+	((std::get<ORDER[I]>(result) =
+			  saco::place_for_overwrite<std::tuple_element_t<ORDER[I], std::tuple<As...>>>(counts[ORDER[I]], ctx)),
+			...);
+	return result;
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Places several arrays at once (like place_for_overwrite<A>(count, ctx) for each of them) and lays them out by
+// descending alignment instead of in the order they are listed, which avoids padding between them.
+// Returns the arrays in the order they are listed (all null in measure mode, and null for arrays with zero elements).
+//
+//     auto [names, weights, flags] = saco::place_sorted_for_overwrite<char[], double[], bool[]>(ctx, n, n, n);
+template <class... As, class Context, class... Counts>
+std::tuple<std::remove_extent_t<As>*...> place_sorted_for_overwrite(Context& ctx, Counts... counts) {
+	static_assert((detail::is_unbounded_array_v<As> && ...), "place_sorted_for_overwrite takes unbounded arrays");
+	static_assert(sizeof...(As) == sizeof...(Counts), "one count per array is required");
+
+	return detail::place_sorted_impl<As...>(
+			ctx,
+			{static_cast<std::size_t>(counts)...},
+			std::make_index_sequence<sizeof...(As)>{});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Context handed to the builders of cold parts, every part placed through it (including nested ones) is cold.
+template <class Context>
+class cold_context final {
+public:
+	static constexpr bool is_construct_context = Context::is_construct_context;
+
+	cold_context(cold_context&&) = delete;
+
+	constexpr explicit cold_context(Context& ctx) : m_ctx{ctx} {
+	}
+
+	template <class T>
+	constexpr void* allocate_space() {
+		return m_ctx.template allocate_cold_space<T>(1);
+	}
+
+	template <class T>
+	constexpr void* allocate_space(std::size_t count) {
+		return m_ctx.template allocate_cold_space<T>(count);
+	}
+
+	template <class T>
+	constexpr void* allocate_cold_space(std::size_t count) {
+		return m_ctx.template allocate_cold_space<T>(count);
+	}
+
+	template <class MeasureOne>
+	constexpr void measure_repeated(std::size_t count, MeasureOne const& measure_one) {
+		m_ctx.measure_repeated(count, measure_one);
+	}
+
+private:
+	Context& m_ctx;
+};
+
+// Like place and place_for_overwrite, but for rarely used parts (debug names, metadata, ...).
+// Cold parts are laid out at the end of the block, so the root and all other (hot) parts stay contiguous and
+// traversals don't pull cold data into the cache. Cold parts must not be over-aligned.
+
+template <class T, class Context, class... Args, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place_cold(Context& ctx, Args&&... args) {
+	cold_context<Context> cold{ctx};
+	return saco::place<T>(cold, std::forward<Args>(args)...);
+}
+
+template <class A, class Context, class... Args, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_cold(std::size_t count, Context& ctx, Args&&... args) {
+	cold_context<Context> cold{ctx};
+	return saco::place<A>(count, cold, std::forward<Args>(args)...);
+}
+
+template <class T, class Context, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place_cold_for_overwrite(Context& ctx) {
+	cold_context<Context> cold{ctx};
+	return saco::place_for_overwrite<T>(cold);
+}
+
+template <class A, class Context, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_cold_for_overwrite(std::size_t count, Context& ctx) {
+	cold_context<Context> cold{ctx};
+	return saco::place_for_overwrite<A>(count, cold);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Context that starts the first space allocated through it on a cache line of its own and pads it to whole lines.
+// Everything after that (the sub-objects of the isolated object) is allocated from the wrapped context as usual.
+template <class Context>
+class isolated_context final {
+public:
+	static constexpr bool is_construct_context = Context::is_construct_context;
+
+	isolated_context(isolated_context&&) = delete;
+
+	constexpr explicit isolated_context(Context& ctx) : m_ctx{ctx} {
+	}
+
+	template <class T>
+	constexpr void* allocate_space() {
+		return allocate_space<T>(1);
+	}
+
+	template <class T>
+	constexpr void* allocate_space(std::size_t count) {
+		if (m_isolated)
+			return m_ctx.template allocate_space<T>(count);
+
+		static_assert(alignof(T) <= SACO_CACHE_LINE_SIZE, "type is aligned beyond SACO_CACHE_LINE_SIZE");
+		m_isolated = true;
+		std::size_t const lines = (sizeof(T) * count + sizeof(cache_line) - 1) / sizeof(cache_line);
+		return m_ctx.template allocate_space<cache_line>(lines);
+	}
+
+	template <class T>
+	constexpr void* allocate_cold_space(std::size_t count) {
+		return m_ctx.template allocate_cold_space<T>(count);
+	}
+
+	template <class MeasureOne>
+	constexpr void measure_repeated(std::size_t count, MeasureOne const& measure_one) {
+		m_ctx.measure_repeated(count, measure_one);
+	}
+
+private:
+	struct alignas(SACO_CACHE_LINE_SIZE) cache_line {
+		byte bytes[SACO_CACHE_LINE_SIZE];
+	};
+
+	Context& m_ctx;
+	bool m_isolated{false};
+};
+
+// Like place and place_for_overwrite, but the object (or the whole array) gets cache lines of its own: it starts on a
+// line boundary and nothing else is placed on its last line. Use it for parts that are written often (per-thread
+// counters, locks, ...) so they don't invalidate the read-mostly lines around them on other cores. The type does not
+// need to be declared with alignas, which keeps it usable outside of saco blocks without wasting space there.
+//
+//     stats = saco::place_isolated<std::atomic<std::uint64_t>[]>(thread_count, ctx, 0);
+
+template <class T, class Context, class... Args, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place_isolated(Context& ctx, Args&&... args) {
+	isolated_context<Context> isolated{ctx};
+	return saco::place<T>(isolated, std::forward<Args>(args)...);
+}
+
+template <class A, class Context, class... Args, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_isolated(std::size_t count, Context& ctx, Args&&... args) {
+	isolated_context<Context> isolated{ctx};
+	return saco::place<A>(count, isolated, std::forward<Args>(args)...);
+}
+
+template <class T, class Context, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place_isolated_for_overwrite(Context& ctx) {
+	isolated_context<Context> isolated{ctx};
+	return saco::place_for_overwrite<T>(isolated);
+}
+
+template <class A, class Context, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_isolated_for_overwrite(std::size_t count, Context& ctx) {
+	isolated_context<Context> isolated{ctx};
+	return saco::place_for_overwrite<A>(count, isolated);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <saco/allocator.h>
+#include <saco/huge_page.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+
+#if !defined(__linux__)
+#error "saco/numa.h requires Linux"
+#endif
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Node argument of numa_allocator and build_unique_on_node: the node of the CPU the allocating thread runs on.
+inline constexpr int LOCAL_NUMA_NODE = -1;
+
+// Node of the CPU the calling thread currently runs on (0 without NUMA support).
+inline int current_numa_node() {
+	unsigned cpu = 0;
+	unsigned node = 0;
+	if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+		return 0;
+	return static_cast<int>(node);
+}
+
+namespace detail {
+
+// Node numbers supported by bind_to_numa_node, the same limit as the kernel's default CONFIG_NODES_SHIFT maximum.
+inline constexpr int MAX_NUMA_NODES = 1024;
+
+// MPOL_PREFERRED from <numaif.h>, which is part of libnuma and not always installed.
+inline constexpr int NUMA_MPOL_PREFERRED = 1;
+
+inline void check_numa_node(int node) {
+	if (node < 0 || node >= MAX_NUMA_NODES)
+		throw std::system_error(EINVAL, std::generic_category(), "saco: mbind");
+}
+
+// Makes the kernel allocate the pages of a mapping on `node`, falling back to other nodes only when it is out of
+// memory. The pages are allocated when they are first written, which is when the object is constructed.
+//
+// Where the placement can't be applied at all, the pages are allocated wherever the kernel sees fit, as without a node.
+inline void bind_to_numa_node(void* memory, std::size_t size, int node) {
+	constexpr int BITS = sizeof(unsigned long) * CHAR_BIT;
+	check_numa_node(node);
+
+	unsigned long mask[MAX_NUMA_NODES / BITS] = {};
+	mask[node / BITS] = 1ul << (node % BITS);
+	if (::syscall(SYS_mbind, memory, size, NUMA_MPOL_PREFERRED, mask, MAX_NUMA_NODES + 1, 0) != 0) {
+		// ENOSYS: kernels without NUMA support only have one node anyway
+		// EPERM: mbind is filtered out, e.g. by the default seccomp profile of containers
+		if (errno != ENOSYS && errno != EPERM)
+			throw std::system_error(errno, std::generic_category(), "saco: mbind");
+	}
+}
+
+inline void* map_on_numa_node(std::size_t size, int node) {
+	if (node == LOCAL_NUMA_NODE)
+		node = current_numa_node();
+	check_numa_node(node);
+
+	void* memory;
+	if (size >= HUGE_PAGE_SIZE)
+		memory = map_huge(size);
+	else {
+		memory = ::mmap(nullptr, huge_mapping_size(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED)
+			throw std::bad_alloc();
+	}
+
+	try {
+		bind_to_numa_node(memory, huge_mapping_size(size), node);
+	} catch (...) {
+		unmap_huge(memory, size);
+		throw;
+	}
+	return memory;
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Allocator that places every allocation on the pages of one NUMA node. Allocations are whole pages (and huge pages
+// from a huge page on), so this is meant for blocks that hold a whole object graph, not for individual small objects.
+//
+// With LOCAL_NUMA_NODE, the node is the one of the CPU the allocating thread runs on at the time of the allocation.
+template <class T>
+class numa_allocator {
+public:
+	using value_type = T;
+
+	explicit numa_allocator(int node) : m_node{node} {
+	}
+
+	template <class U>
+	numa_allocator(numa_allocator<U> const& other) : m_node{other.node()} {
+	}
+
+	T* allocate(std::size_t n) {
+		if (n > static_cast<std::size_t>(-1) / sizeof(T))
+			throw std::bad_array_new_length();
+		return static_cast<T*>(detail::map_on_numa_node(n * sizeof(T), m_node));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept {
+		detail::unmap_huge(p, n * sizeof(T));
+	}
+
+	int node() const {
+		return m_node;
+	}
+
+	template <class U>
+	bool operator==(numa_allocator<U> const&) const {
+		// memory can be freed through any of them
+		return true;
+	}
+
+	template <class U>
+	bool operator!=(numa_allocator<U> const&) const {
+		return false;
+	}
+
+private:
+	int m_node;
+};
+
+template <class T>
+using numa_unique_ptr = allocator_unique_ptr<T, numa_allocator<byte>>;
+
+// Builds the object with its whole block on NUMA node `node` (or LOCAL_NUMA_NODE). As all sub-objects are in that
+// block, all of them end up on that node, too.
+template <class T, class... Args>
+numa_unique_ptr<T> build_unique_on_node(int node, Args&&... args) {
+	return build_unique_with<T>(numa_allocator<byte>{node}, std::forward<Args>(args)...);
+}
+
+template <class T, class... Args>
+std::shared_ptr<T> build_shared_on_node(int node, Args&&... args) {
+	return build_shared_with<T>(numa_allocator<byte>{node}, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
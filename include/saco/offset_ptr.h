@@ -0,0 +1,291 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Non-owning pointer to another part of the same block, stored as a signed offset relative to itself.
+//
+// Because the target is encoded relative to the offset_ptr's own address, a block whose interior references are all
+// offset_ptrs stays valid when it is copied or moved as a whole (memcpy, realloc, written to a file and mapped back).
+// With a small Offset type the pointer also shrinks from 8 to 1, 2 or 4 bytes. Constructing an offset_ptr to a target
+// that is too far away for Offset throws std::out_of_range.
+//
+// offset_ptrs cannot be copied or moved individually, that would make them point somewhere else.
+template <class T, class Offset = std::int32_t>
+class offset_ptr {
+	static_assert(std::is_integral_v<Offset>);
+	static_assert(std::is_signed_v<Offset>);
+
+public:
+	using element_type = T;
+	using offset_type = Offset;
+
+	offset_ptr(offset_ptr&&) = delete;
+
+	offset_ptr() : m_offset{0} {
+	}
+
+	explicit offset_ptr(T* p) : m_offset{encode(p)} {
+	}
+
+	offset_ptr& operator=(T* p) {
+		m_offset = encode(p);
+		return *this;
+	}
+
+	explicit operator bool() const {
+		return m_offset != 0;
+	}
+
+	bool operator!() const {
+		return m_offset == 0;
+	}
+
+	T* get() const {
+		return decode();
+	}
+
+	T* operator->() const {
+		return decode();
+	}
+
+	T& operator*() const {
+		return *decode();
+	}
+
+	Offset offset() const {
+		return m_offset;
+	}
+
+private:
+	T* decode() const {
+		auto const my_addr = reinterpret_cast<std::uintptr_t>(&m_offset);
+		auto const p_addr = my_addr + static_cast<std::uintptr_t>(static_cast<std::ptrdiff_t>(m_offset));
+		return m_offset ? reinterpret_cast<T*>(p_addr) : nullptr;
+	}
+
+	Offset encode(T* p) const {
+		auto const p_addr = reinterpret_cast<std::uintptr_t>(p);
+		auto const my_addr = reinterpret_cast<std::uintptr_t>(&m_offset);
+		auto const offset = p ? static_cast<std::ptrdiff_t>(p_addr - my_addr) : 0;
+		if (SACO_UNLIKELY(offset < std::numeric_limits<Offset>::min() || offset > std::numeric_limits<Offset>::max()))
+			detail::throw_offset_out_of_range();
+		return static_cast<Offset>(offset);
+	}
+
+	Offset m_offset;
+};
+
+template <class T>
+using o8_ptr = offset_ptr<T, std::int8_t>;
+template <class T>
+using o16_ptr = offset_ptr<T, std::int16_t>;
+template <class T>
+using o32_ptr = offset_ptr<T, std::int32_t>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+template <class Base, bool IS_TRIVIALLY_DESTRUCTIBLE>
+class offset_ptr_dtor_impl;
+
+template <class Base>
+class offset_ptr_dtor_impl<Base, true> : public Base {
+	static_assert(std::is_trivially_destructible_v<typename Base::element_type>);
+
+public:
+	using Base::Base;
+	using Base::operator=;
+};
+
+template <class Base>
+class offset_ptr_dtor_impl<Base, false> : public Base {
+public:
+	using Base::Base;
+	using Base::operator=;
+
+	~offset_ptr_dtor_impl() {
+		if (*this) {
+			using T = typename Base::element_type;
+			this->get()->~T();
+		}
+	}
+};
+
+} // namespace detail
+
+// offset_ptr that destroys its target, for sub-objects placed into the same block.
+template <class T, class Offset = std::int32_t>
+class unique_offset_ptr :
+		public detail::offset_ptr_dtor_impl<offset_ptr<T, Offset>, std::is_trivially_destructible_v<T>> {
+	using _base = detail::offset_ptr_dtor_impl<offset_ptr<T, Offset>, std::is_trivially_destructible_v<T>>;
+
+public:
+	using _base::_base;
+	using _base::operator=;
+};
+
+template <class T>
+using unique_o8_ptr = unique_offset_ptr<T, std::int8_t>;
+template <class T>
+using unique_o16_ptr = unique_offset_ptr<T, std::int16_t>;
+template <class T>
+using unique_o32_ptr = unique_offset_ptr<T, std::int32_t>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Non-owning view of an array in the same block, the relocatable counterpart of a pointer + size pair.
+// The size uses the unsigned counterpart of Offset, so e.g. an offset_span<char, std::int16_t> takes 4 bytes.
+template <class T, class Offset = std::int32_t>
+class offset_span {
+public:
+	using element_type = T;
+	using size_type = std::make_unsigned_t<Offset>;
+	using iterator = T*;
+
+	offset_span(offset_span&&) = delete;
+
+	offset_span() = default;
+
+	offset_span(T* data, std::size_t size) : m_data{data}, m_size{encode_size(size)} {
+	}
+
+	T* data() const {
+		return m_data.get();
+	}
+
+	std::size_t size() const {
+		return m_size;
+	}
+
+	bool empty() const {
+		return m_size == 0;
+	}
+
+	iterator begin() const {
+		return m_data.get();
+	}
+
+	iterator end() const {
+		return m_data.get() + m_size;
+	}
+
+	T& operator[](std::size_t index) const {
+		SACO_ASSERT(index < m_size);
+		return m_data.get()[index];
+	}
+
+private:
+	static size_type encode_size(std::size_t size) {
+		if (SACO_UNLIKELY(size > std::numeric_limits<size_type>::max()))
+			detail::throw_offset_out_of_range();
+		return static_cast<size_type>(size);
+	}
+
+	offset_ptr<T, Offset> m_data;
+	size_type m_size{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Opt-in marker for types whose blocks can be relocated with a plain memcpy.
+//
+// Specialize this for a type when every reference from the object (and its sub-objects) into its own block is an
+// offset_ptr, unique_offset_ptr or offset_span, and it holds no references to memory outside of the block that
+// would be invalid in a copy (e.g. heap pointers owned by the object).
+template <class T>
+struct is_relocatable : std::false_type {};
+
+template <class T>
+inline constexpr bool is_relocatable_v = is_relocatable<T>::value;
+
+// Deleter for relocatable objects, it remembers the size of the block so the block can be copied.
+template <class T>
+class relocatable_delete {
+public:
+	relocatable_delete() = default;
+
+	explicit relocatable_delete(std::size_t size) : m_size{size} {
+	}
+
+	void operator()(T* p) const {
+		static_assert(sizeof(T) > 0, "type must be complete");
+		p->~T();
+		detail::free_raw<detail::root_alignment_v<T>>(p);
+	}
+
+	std::size_t size() const {
+		return m_size;
+	}
+
+private:
+	std::size_t m_size{0};
+};
+
+template <class T>
+using relocatable_ptr = std::unique_ptr<T, relocatable_delete<T>>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Like build_unique, but for relocatable types. The returned handle knows the size of its block.
+template <class T, class... Args>
+relocatable_ptr<T> build_relocatable(Args&&... args) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+	std::size_t const required_size = mctx.required_size();
+
+	// allocate raw memory
+	std::unique_ptr<void, detail::aligned_raw_delete<ALIGN>> raw_memory(detail::alloc_raw<ALIGN>(required_size));
+
+	// construct
+	construct_context cctx{raw_memory.get(), required_size};
+	relocatable_ptr<T> obj(saco::place<T>(cctx, std::forward<Args>(args)...), relocatable_delete<T>{required_size});
+	[[maybe_unused]] auto const rmem = raw_memory.release();
+	SACO_ASSERT(obj.get() == static_cast<void*>(rmem));
+	return obj;
+}
+
+// Copies a relocatable object's block to `dest`, which must be aligned to root_alignment_v<T> and at least `size`
+// bytes large. Returns the copy, which must be destroyed with ~T() (if not trivially destructible) before `dest` is
+// freed.
+template <class T>
+T* relocate_copy(T const* obj, std::size_t size, void* dest) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+	SACO_ASSERT(reinterpret_cast<std::uintptr_t>(dest) % detail::root_alignment_v<T> == 0);
+	std::memcpy(dest, static_cast<void const*>(obj), size);
+	return std::launder(static_cast<T*>(dest));
+}
+
+// Clones a relocatable object with a single allocation and a single memcpy, no builder runs.
+template <class T>
+relocatable_ptr<T> clone(relocatable_ptr<T> const& obj) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+
+	if (!obj)
+		return nullptr;
+
+	std::size_t const size = obj.get_deleter().size();
+	void* const memory = detail::alloc_raw<ALIGN>(size);
+	return relocatable_ptr<T>(saco::relocate_copy(obj.get(), size, memory), relocatable_delete<T>{size});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
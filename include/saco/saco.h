@@ -1,255 +1,512 @@
-#pragma once
-
-#include <saco/xcore.h>
-#include <saco/xutility.h>
-
-#include <memory>
-#include <type_traits>
-#include <utility>
-
-namespace saco {
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T>
-struct saco_delete {
-	void operator()(T* p) const {
-		static_assert(sizeof(T) > 0, "type must be complete");
-		p->~T();
-		detail::free_raw(p);
-	}
-};
-
-template <class T>
-using unique_ptr = std::unique_ptr<T, saco_delete<T>>;
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-namespace detail {
-
-template <std::size_t ALIGN, class Offset>
-SACO_ALWAYS_INLINE Offset align(Offset ref_offset) {
-	static_assert(is_power_of_two(ALIGN));
-	static constexpr std::size_t MASK = ALIGN - 1;
-	return (ref_offset + MASK) & ~MASK;
-}
-
-template <std::size_t ALIGN, class Offset>
-SACO_ALWAYS_INLINE Offset align_and_add(Offset& ref_offset, std::size_t size) {
-	Offset const aligned = align<ALIGN>(ref_offset);
-	ref_offset = aligned + size;
-	return aligned;
-}
-
-} // namespace detail
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class measure_context final {
-public:
-	static constexpr bool is_construct_context = false;
-
-	measure_context(measure_context&&) = delete;
-	SACO_ALWAYS_INLINE measure_context() = default;
-
-	template <class T>
-	SACO_ALWAYS_INLINE void* allocate_space() {
-		static_assert(sizeof(T) % alignof(T) == 0);
-		return allocate_space_0<alignof(T)>(sizeof(T));
-	}
-
-	template <class T>
-	SACO_ALWAYS_INLINE void* allocate_space(std::size_t count) {
-		static_assert(sizeof(T) % alignof(T) == 0);
-		return allocate_space_0<alignof(T)>(sizeof(T) * count);
-	}
-
-	std::size_t required_size() const {
-		return this->m_offset + m_extra_padding;
-	}
-
-private:
-	template <std::size_t ALIGN>
-	SACO_ALWAYS_INLINE void* allocate_space_0(std::size_t size) {
-		if SACO_IF_CONSTEXPR (ALIGN <= detail::MAX_NEW_ALIGNMENT)
-			detail::align_and_add<ALIGN>(m_offset, size);
-		else
-			allocate_space_1<ALIGN>(size);
-		return nullptr;
-	}
-
-	template <std::size_t ALIGN>
-	void allocate_space_1(std::size_t size) {
-		if (ALIGN <= m_free_alignment)
-			detail::align_and_add<ALIGN>(m_offset, size);
-		else
-			allocate_over_aligned<ALIGN>(size);
-	}
-
-	template <std::size_t ALIGN>
-	void allocate_over_aligned(std::size_t size) {
-		SACO_ASSERT_MSG(m_offset != 0, "head must not be over-aligned");
-
-		auto const fa_mask = m_free_alignment - 1u;
-		m_offset = (m_offset + fa_mask) & ~fa_mask;
-
-		std::size_t const old_offset = m_offset;
-		std::size_t const offset = detail::align_and_add<ALIGN>(m_offset, size);
-
-		// amount of padding already accounted for my increased m_offset
-		std::size_t const padding = offset - old_offset;
-		// amount of extra padding that may be required to achieve ALIGN
-		std::size_t const extra_padding = ALIGN - padding - m_free_alignment;
-
-		m_extra_padding += extra_padding;
-		m_free_alignment = ALIGN;
-	}
-
-	static_assert(detail::is_power_of_two(detail::MAX_NEW_ALIGNMENT));
-
-	std::size_t m_offset{0};
-	std::size_t m_free_alignment{detail::MAX_NEW_ALIGNMENT};
-	std::size_t m_extra_padding{0};
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class construct_context final {
-public:
-	static constexpr bool is_construct_context = true;
-
-	construct_context(construct_context&&) = delete;
-
-	SACO_ALWAYS_INLINE construct_context(void* mem, std::size_t size) :
-			m_current{reinterpret_cast<std::uintptr_t>(mem)},
-			m_end{m_current + size} {
-	}
-
-	SACO_ALWAYS_INLINE void* current() {
-		return reinterpret_cast<void*>(m_current);
-	}
-
-	template <class T>
-	SACO_ALWAYS_INLINE void* allocate_space() {
-		static_assert(sizeof(T) % alignof(T) == 0);
-		return allocate_space_0<alignof(T)>(sizeof(T));
-	}
-
-	template <class T>
-	SACO_ALWAYS_INLINE void* allocate_space(std::size_t count) {
-		static_assert(sizeof(T) % alignof(T) == 0);
-		return allocate_space_0<alignof(T)>(sizeof(T) * count);
-	}
-
-private:
-	template <std::size_t ALIGN>
-	void* allocate_space_0(std::size_t size) {
-		auto const address = detail::align_and_add<ALIGN>(m_current, size);
-		SACO_ASSERT(m_current <= m_end);
-		return reinterpret_cast<void*>(address);
-	}
-
-	std::uintptr_t m_current;
-	std::uintptr_t m_end;
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T>
-struct builder;
-
-template <class T, std::size_t N>
-struct builder<T[N]> {};
-template <class T>
-struct builder<T[]> {};
-
-template <class T>
-struct builder {
-	template <class Context, class... Args>
-	static SACO_ALWAYS_INLINE T* build(void* memory, Context& ctx, Args&&... args) {
-		if SACO_IF_CONSTRUCT_CONTEXT (Context)
-			return ::new (memory) T(std::forward<Args>(args)...);
-		else
-			return nullptr;
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T, class Context, class... Args, SACO_REQUIRES_NON_ARRAY(T)>
-T* place(Context& ctx, Args&&... args) {
-	auto const memory = ctx.template allocate_space<T>();
-	return builder<T>::build(memory, ctx, std::forward<Args>(args)...);
-}
-
-template <class T, class Context, SACO_REQUIRES_NON_ARRAY(T)>
-T* place_for_overwrite(Context& ctx) {
-	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>();
-	if SACO_IF_CONSTRUCT_CONTEXT (Context)
-		return ::new (memory) T;
-	else
-		return nullptr;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class A, class Context, class... Args, SACO_REQUIRES_UB_ARRAY(A)>
-std::remove_extent_t<A>* place(std::size_t count, Context& ctx, Args&&... args) {
-	using T = std::remove_extent_t<A>;
-
-	if (count == 0)
-		return nullptr;
-
-	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>(count);
-
-	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
-		auto const ts = static_cast<T*>(memory); // bless
-		for (std::size_t i = 0; i < count; i++)
-			builder<T>::build(&ts[i], ctx, std::forward<Args>(args)...);
-		return ts;
-	} else
-		return nullptr;
-}
-
-template <class A, class Context, SACO_REQUIRES_UB_ARRAY(A)>
-std::remove_extent_t<A>* place_for_overwrite(std::size_t count, Context& ctx) {
-	using T = std::remove_extent_t<A>;
-
-	if (count == 0)
-		return nullptr;
-
-	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>(count);
-
-	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
-		auto const ts = static_cast<T*>(memory); // bless
-		for (std::size_t i = 0; i < count; i++)
-			::new (&ts[i]) T;
-		return ts;
-	} else
-		return nullptr;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T, class... Args>
-unique_ptr<T> build_unique(Args&&... args) {
-	static_assert(alignof(T) <= detail::MAX_NEW_ALIGNMENT);
-	// measure
-	measure_context mctx;
-	saco::place<T>(mctx, std::as_const(args)...);
-	std::size_t const required_size = mctx.required_size();
-
-	// allocate raw memory
-	std::unique_ptr<void, detail::raw_delete> raw_memory(detail::alloc_raw(required_size));
-
-	// construct
-	construct_context cctx{raw_memory.get(), required_size};
-	unique_ptr<T> obj(saco::place<T>(cctx, std::forward<Args>(args)...));
-	[[maybe_unused]] auto const rmem = raw_memory.release();
-	SACO_ASSERT(obj.get() == static_cast<void*>(rmem));
-	return obj;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace saco
+#pragma once
+
+#include <saco/xcore.h>
+#include <saco/xstats.h>
+#include <saco/xutility.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+struct saco_delete {
+	void operator()(T* p) const {
+		static_assert(sizeof(T) > 0, "type must be complete");
+		p->~T();
+		detail::free_raw<alignof(T)>(p);
+	}
+};
+
+template <class T>
+using unique_ptr = std::unique_ptr<T, saco_delete<T>>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+template <std::size_t ALIGN, class Offset>
+SACO_ALWAYS_INLINE constexpr Offset align(Offset ref_offset) {
+	static_assert(is_power_of_two(ALIGN));
+	constexpr std::size_t MASK = ALIGN - 1;
+	return (ref_offset + MASK) & ~MASK;
+}
+
+template <std::size_t ALIGN, class Offset>
+SACO_ALWAYS_INLINE constexpr Offset align_and_add(Offset& ref_offset, std::size_t size) {
+	Offset const aligned = align<ALIGN>(ref_offset);
+	ref_offset = aligned + size;
+	return aligned;
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Layout rules of the measure contexts. Everything is constexpr, so that static_measure_context can lay out builders
+// at compile time with the same rules that measure_context applies at run time. The payload (for padding_size) is
+// only tracked if TRACK_PAYLOAD is set.
+template <bool TRACK_PAYLOAD>
+class basic_measure_context {
+public:
+	static constexpr bool is_construct_context = false;
+
+	basic_measure_context(basic_measure_context&&) = delete;
+	SACO_ALWAYS_INLINE constexpr basic_measure_context() = default;
+
+	// `base_alignment` is the alignment of the memory the measured objects will be constructed in.
+	// It must be at least MAX_NEW_ALIGNMENT, larger values allow the head to be over-aligned.
+	SACO_ALWAYS_INLINE constexpr explicit basic_measure_context(std::size_t base_alignment) :
+			m_free_alignment{base_alignment} {
+		SACO_CONSTEXPR_ASSERT(is_power_of_two(base_alignment));
+		SACO_CONSTEXPR_ASSERT(base_alignment >= MAX_NEW_ALIGNMENT);
+	}
+
+	template <class T>
+	SACO_ALWAYS_INLINE constexpr void* allocate_space() {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		return allocate_space_0<alignof(T)>(sizeof(T));
+	}
+
+	template <class T>
+	SACO_ALWAYS_INLINE constexpr void* allocate_space(std::size_t count) {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		return allocate_space_0<alignof(T)>(sizeof(T) * count);
+	}
+
+	// Cold parts are laid out downwards from the end of the block, behind all other parts (see place_cold).
+	template <class T>
+	SACO_ALWAYS_INLINE constexpr void* allocate_cold_space(std::size_t count) {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		static_assert(alignof(T) <= MAX_NEW_ALIGNMENT, "cold parts must not be over-aligned");
+		m_cold_size = align<alignof(T)>(m_cold_size + sizeof(T) * count);
+		add_payload(sizeof(T) * count);
+		return nullptr;
+	}
+
+	constexpr std::size_t required_size() const {
+		std::size_t const size = m_offset + m_extra_padding;
+		if (SACO_LIKELY(m_cold_size == 0))
+			return size;
+		// the cold parts were measured from an end aligned to MAX_NEW_ALIGNMENT
+		return align<MAX_NEW_ALIGNMENT>(size) + align<MAX_NEW_ALIGNMENT>(m_cold_size);
+	}
+
+	// Part of required_size() that is padding rather than objects. Only tracked with TRACK_PAYLOAD, 0 otherwise.
+	constexpr std::size_t padding_size() const {
+		if SACO_IF_CONSTEXPR (TRACK_PAYLOAD)
+			return required_size() - m_payload_size;
+		else
+			return 0;
+	}
+
+	// Measures `count` objects that all place the same things, `measure_one` measures a single one.
+	// If measuring one object leaves the alignment state unchanged, the others are accounted for by multiplication.
+	template <class MeasureOne>
+	constexpr void measure_repeated(std::size_t count, MeasureOne const& measure_one) {
+		if (count == 0)
+			return;
+
+		std::size_t const offset = m_offset;
+		std::size_t const free_alignment = m_free_alignment;
+		std::size_t const extra_padding = m_extra_padding;
+		std::size_t const cold_size = m_cold_size;
+		std::size_t const payload_size = m_payload_size;
+		measure_one();
+
+		std::size_t const delta = m_offset - offset;
+		std::size_t const cold_delta = m_cold_size - cold_size;
+		if (m_free_alignment == free_alignment && m_extra_padding == extra_padding && delta % free_alignment == 0 &&
+				cold_delta % MAX_NEW_ALIGNMENT == 0) {
+			m_offset += delta * (count - 1);
+			m_cold_size += cold_delta * (count - 1);
+			add_payload((m_payload_size - payload_size) * (count - 1));
+			return;
+		}
+
+		for (std::size_t i = 1; i < count; i++)
+			measure_one();
+	}
+
+private:
+	SACO_ALWAYS_INLINE constexpr void add_payload([[maybe_unused]] std::size_t size) {
+		if SACO_IF_CONSTEXPR (TRACK_PAYLOAD)
+			m_payload_size += size;
+	}
+
+	template <std::size_t ALIGN>
+	SACO_ALWAYS_INLINE constexpr void* allocate_space_0(std::size_t size) {
+		add_payload(size);
+		if SACO_IF_CONSTEXPR (ALIGN <= MAX_NEW_ALIGNMENT)
+			align_and_add<ALIGN>(m_offset, size);
+		else
+			allocate_space_1<ALIGN>(size);
+		return nullptr;
+	}
+
+	template <std::size_t ALIGN>
+	constexpr void allocate_space_1(std::size_t size) {
+		if (ALIGN <= m_free_alignment)
+			align_and_add<ALIGN>(m_offset, size);
+		else
+			allocate_over_aligned<ALIGN>(size);
+	}
+
+	template <std::size_t ALIGN>
+	constexpr void allocate_over_aligned(std::size_t size) {
+		SACO_CONSTEXPR_ASSERT_MSG(m_offset != 0, "head must not be over-aligned");
+
+		auto const fa_mask = m_free_alignment - 1u;
+		m_offset = (m_offset + fa_mask) & ~fa_mask;
+
+		std::size_t const old_offset = m_offset;
+		std::size_t const offset = align_and_add<ALIGN>(m_offset, size);
+
+		// amount of padding already accounted for my increased m_offset
+		std::size_t const padding = offset - old_offset;
+		// amount of extra padding that may be required to achieve ALIGN
+		std::size_t const extra_padding = ALIGN - padding - m_free_alignment;
+
+		m_extra_padding += extra_padding;
+		m_free_alignment = ALIGN;
+	}
+
+	static_assert(is_power_of_two(MAX_NEW_ALIGNMENT));
+
+	std::size_t m_offset{0};
+	std::size_t m_free_alignment{MAX_NEW_ALIGNMENT};
+	std::size_t m_extra_padding{0};
+	std::size_t m_cold_size{0};
+	// only maintained with TRACK_PAYLOAD
+	std::size_t m_payload_size{0};
+};
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class measure_context final : public detail::basic_measure_context<detail::STATS_ENABLED> {
+public:
+	using basic_measure_context::basic_measure_context;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Measure context that can be used in constant expressions.
+// Builders that opt into static_layout are measured with it at compile time, see detail::static_size_v.
+// It always tracks the padding, as that costs nothing at compile time.
+class static_measure_context final : public detail::basic_measure_context<true> {
+public:
+	using basic_measure_context::basic_measure_context;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Constructs objects into memory that has previously been sized by a measure_context.
+// The checked variant is used when the size of the memory is only an upper bound that was supplied by the user
+// (see build_unique_bounded), it throws std::length_error instead of running past the end of the memory.
+template <bool CHECKED>
+class basic_construct_context final {
+public:
+	static constexpr bool is_construct_context = true;
+
+	basic_construct_context(basic_construct_context&&) = delete;
+
+	SACO_ALWAYS_INLINE basic_construct_context(void* mem, std::size_t size) :
+			m_current{reinterpret_cast<std::uintptr_t>(mem)},
+			m_cold_end{m_current + size} {
+	}
+
+	SACO_ALWAYS_INLINE void* current() {
+		return reinterpret_cast<void*>(m_current);
+	}
+
+	template <class T>
+	SACO_ALWAYS_INLINE void* allocate_space() {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		return allocate_space_0<alignof(T)>(sizeof(T));
+	}
+
+	template <class T>
+	SACO_ALWAYS_INLINE void* allocate_space(std::size_t count) {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		return allocate_space_0<alignof(T)>(sizeof(T) * count);
+	}
+
+	// Cold parts are placed downwards from the end of the memory. Starting from the real end, which may lie behind the
+	// MAX_NEW_ALIGNMENT aligned end assumed by measure_context, only moves them further up.
+	template <class T>
+	SACO_ALWAYS_INLINE void* allocate_cold_space(std::size_t count) {
+		static_assert(sizeof(T) % alignof(T) == 0);
+		static_assert(alignof(T) <= detail::MAX_NEW_ALIGNMENT, "cold parts must not be over-aligned");
+		std::size_t const size = sizeof(T) * count;
+		if SACO_IF_CONSTEXPR (CHECKED) {
+			if (SACO_UNLIKELY(size > m_cold_end - m_current || align_down<alignof(T)>(m_cold_end - size) < m_current))
+				detail::throw_size_bound_exceeded();
+		}
+		m_cold_end = align_down<alignof(T)>(m_cold_end - size);
+		SACO_ASSERT(m_current <= m_cold_end);
+		return reinterpret_cast<void*>(m_cold_end);
+	}
+
+private:
+	template <std::size_t ALIGN>
+	void* allocate_space_0(std::size_t size) {
+		if SACO_IF_CONSTEXPR (CHECKED) {
+			auto const address = detail::align<ALIGN>(m_current);
+			if (SACO_UNLIKELY(address > m_cold_end || size > m_cold_end - address))
+				detail::throw_size_bound_exceeded();
+		}
+		auto const address = detail::align_and_add<ALIGN>(m_current, size);
+		SACO_ASSERT(m_current <= m_cold_end);
+		return reinterpret_cast<void*>(address);
+	}
+
+	template <std::size_t ALIGN>
+	static std::uintptr_t align_down(std::uintptr_t address) {
+		return address & ~std::uintptr_t{ALIGN - 1};
+	}
+
+	std::uintptr_t m_current;
+	// end of the memory that is still free, cold parts are placed from the end
+	std::uintptr_t m_cold_end;
+};
+
+using construct_context = basic_construct_context<false>;
+using checked_construct_context = basic_construct_context<true>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+struct builder;
+
+template <class T, std::size_t N>
+struct builder<T[N]> {};
+template <class T>
+struct builder<T[]> {};
+
+template <class T>
+struct builder {
+	static constexpr bool uniform_size = true;
+
+	template <class Context, class... Args>
+	static SACO_ALWAYS_INLINE constexpr T* build(void* memory, Context& ctx, Args&&... args) {
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) T(std::forward<Args>(args)...);
+		else
+			return nullptr;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+template <class T, class Void = void>
+struct has_uniform_size : std::false_type {};
+
+template <class T>
+struct has_uniform_size<T, std::void_t<decltype(builder<T>::uniform_size)>> :
+		std::bool_constant<builder<T>::uniform_size> {};
+
+// A builder can declare `static constexpr bool uniform_size = true` when every object it builds from the same
+// arguments places the same sub-objects. Arrays of such objects are then measured by measuring a single element.
+template <class T>
+inline constexpr bool has_uniform_size_v = has_uniform_size<T>::value;
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, class Context, class... Args, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place(Context& ctx, Args&&... args) {
+	auto const memory = ctx.template allocate_space<T>();
+	return builder<T>::build(memory, ctx, std::forward<Args>(args)...);
+}
+
+template <class T, class Context, SACO_REQUIRES_NON_ARRAY(T)>
+constexpr T* place_for_overwrite(Context& ctx) {
+	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>();
+	if SACO_IF_CONSTRUCT_CONTEXT (Context)
+		return ::new (memory) T;
+	else
+		return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class A, class Context, class... Args, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place(std::size_t count, Context& ctx, Args&&... args) {
+	using T = std::remove_extent_t<A>;
+
+	if (count == 0)
+		return nullptr;
+
+	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>(count);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		auto const ts = static_cast<T*>(memory); // bless
+		for (std::size_t i = 0; i < count; i++)
+			builder<T>::build(&ts[i], ctx, std::forward<Args>(args)...);
+		return ts;
+	} else {
+		// the elements may place sub-objects of their own
+		if SACO_IF_CONSTEXPR (detail::has_uniform_size_v<T>) {
+			ctx.measure_repeated(count, [&] { builder<T>::build(nullptr, ctx, std::as_const(args)...); });
+		} else {
+			for (std::size_t i = 0; i < count; i++)
+				builder<T>::build(nullptr, ctx, std::as_const(args)...);
+		}
+		return nullptr;
+	}
+}
+
+template <class A, class Context, SACO_REQUIRES_UB_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_for_overwrite(std::size_t count, Context& ctx) {
+	using T = std::remove_extent_t<A>;
+
+	if (count == 0)
+		return nullptr;
+
+	[[maybe_unused]] auto const memory = ctx.template allocate_space<T>(count);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		auto const ts = static_cast<T*>(memory); // bless
+		for (std::size_t i = 0; i < count; i++)
+			::new (&ts[i]) T;
+		return ts;
+	} else
+		return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Bounded arrays have a compile-time element count, which keeps the layout static (see static_layout below).
+
+template <class A, class Context, class... Args, SACO_REQUIRES_BOUNDED_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place(Context& ctx, Args&&... args) {
+	return saco::place<std::remove_extent_t<A>[]>(std::extent_v<A>, ctx, std::forward<Args>(args)...);
+}
+
+template <class A, class Context, SACO_REQUIRES_BOUNDED_ARRAY(A)>
+constexpr std::remove_extent_t<A>* place_for_overwrite(Context& ctx) {
+	return saco::place_for_overwrite<std::remove_extent_t<A>[]>(std::extent_v<A>, ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+template <class T, class Void, class... Args>
+struct has_max_size : std::false_type {};
+
+template <class T, class... Args>
+struct has_max_size<T, std::void_t<decltype(builder<T>::max_size(std::declval<Args const&>()...))>, Args...> :
+		std::true_type {};
+
+// A builder can declare a cheap upper bound for the size of the objects it builds by providing
+// `static std::size_t max_size(Args const&...)`. build_unique and build_shared then skip the measure pass.
+template <class T, class... Args>
+inline constexpr bool has_max_size_v = has_max_size<T, void, std::decay_t<Args>...>::value;
+
+template <class T, class Void = void>
+struct has_static_layout : std::false_type {};
+
+template <class T>
+struct has_static_layout<T, std::void_t<decltype(builder<T>::static_layout(std::declval<static_measure_context&>()))>> :
+		std::true_type {};
+
+// A builder can declare that the sizes of everything it places are compile-time constants (sub-objects and bounded
+// arrays only) by providing `static constexpr void static_layout(static_measure_context&)`, which places the same
+// sub-objects as its build function does in measure mode, for any arguments. It is evaluated once at compile time,
+// and build_unique and build_shared skip the measure pass.
+template <class T>
+inline constexpr bool has_static_layout_v = has_static_layout<T>::value;
+
+struct static_measurement {
+	std::size_t size;
+	// part of `size` that is padding, see measure_context::padding_size
+	std::size_t padding;
+};
+
+template <class T>
+constexpr static_measurement static_measure() {
+	static_measure_context mctx{root_alignment_v<T>};
+	mctx.allocate_space<T>();
+	builder<T>::static_layout(mctx);
+	return {mctx.required_size(), mctx.padding_size()};
+}
+
+// measured once per type, static_size_v and static_padding_v are taken from it
+template <class T>
+inline constexpr static_measurement static_measurement_v = static_measure<T>();
+
+template <class T>
+inline constexpr std::size_t static_size_v = static_measurement_v<T>.size;
+
+template <class T>
+inline constexpr std::size_t static_padding_v = static_measurement_v<T>.padding;
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds the object in a single pass, without measuring it first.
+// `max_size` must be an upper bound for the size that would have been measured, otherwise std::length_error is thrown.
+template <class T, class... Args>
+unique_ptr<T> build_unique_bounded(std::size_t max_size, Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+
+	// allocate raw memory
+	std::unique_ptr<void, detail::aligned_raw_delete<ALIGN>> raw_memory(detail::alloc_raw<ALIGN>(max_size));
+
+	// construct
+	checked_construct_context cctx{raw_memory.get(), max_size};
+	unique_ptr<T> obj(saco::place<T>(cctx, std::forward<Args>(args)...));
+	[[maybe_unused]] auto const rmem = raw_memory.release();
+	SACO_ASSERT(obj.get() == static_cast<void*>(rmem));
+	detail::record_build<T>(max_size, 0, max_size);
+	return obj;
+}
+
+template <class T, class... Args>
+unique_ptr<T> build_unique(Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	if SACO_IF_CONSTEXPR (!detail::has_static_layout_v<T> && detail::has_max_size_v<T, Args...>) {
+		std::size_t const max_size = builder<T>::max_size(std::as_const(args)...);
+		return build_unique_bounded<T>(max_size, std::forward<Args>(args)...);
+	}
+
+	// measure
+	std::size_t required_size;
+	[[maybe_unused]] std::size_t padding_size;
+	if SACO_IF_CONSTEXPR (detail::has_static_layout_v<T>) {
+		required_size = detail::static_size_v<T>;
+		padding_size = detail::static_padding_v<T>;
+	} else {
+		measure_context mctx{ALIGN};
+		saco::place<T>(mctx, std::as_const(args)...);
+		required_size = mctx.required_size();
+		padding_size = mctx.padding_size();
+	}
+
+	// allocate raw memory
+	std::unique_ptr<void, detail::aligned_raw_delete<ALIGN>> raw_memory(detail::alloc_raw<ALIGN>(required_size));
+
+	// construct
+	construct_context cctx{raw_memory.get(), required_size};
+	unique_ptr<T> obj(saco::place<T>(cctx, std::forward<Args>(args)...));
+	[[maybe_unused]] auto const rmem = raw_memory.release();
+	SACO_ASSERT(obj.get() == static_cast<void*>(rmem));
+	detail::record_build<T>(required_size, padding_size, required_size);
+	return obj;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -1,107 +1,345 @@
-#pragma once
-
-#include <saco/saco.h>
-#include <saco/xsize_dispatcher.h>
-
-namespace saco::detail {
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-struct shared_buffer_header {
-	explicit shared_buffer_header(void* object) : object{object}, dtor_fn{nullptr} {
-	}
-
-	~shared_buffer_header() {
-		if (dtor_fn)
-			dtor_fn(object);
-	}
-
-	void (*dtor_fn)(void*);
-	void* object;
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <bool HAS_TRIVIAL_DTOR>
-struct set_dtor_fn_impl;
-
-template <>
-struct set_dtor_fn_impl<true> {
-	template <class T>
-	static void set_dtor_fn(shared_buffer_header&) {
-		// no need to call trivial dtor
-	}
-};
-
-template <>
-struct set_dtor_fn_impl<false> {
-	template <class T>
-	static void set_dtor_fn(shared_buffer_header& sbh) {
-		sbh.dtor_fn = &detail::call_dtor<T>;
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <std::size_t N>
-struct shared_buffer : shared_buffer_header {
-	shared_buffer() : shared_buffer_header(&storage) {
-	}
-
-	alignas(MAX_NEW_ALIGNMENT) byte storage[N];
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-struct shared_alloc_impl {
-	template <std::size_t OBJECT_SIZE>
-	struct shared_buffer_factory {
-		std::shared_ptr<shared_buffer_header> operator()() const {
-			if SACO_IF_CONSTEXPR (OBJECT_SIZE > 0)
-				return std::make_shared<shared_buffer<OBJECT_SIZE>>();
-			else
-				return std::make_shared<shared_buffer<1>>();
-		}
-	};
-
-	using dispatcher = size_dispatcher_nested_if;
-	static constexpr std::size_t MAX_SIZE = dispatcher::MAX_SIZE;
-
-	static SACO_NOINLINE std::shared_ptr<shared_buffer_header> alloc(std::size_t s) {
-		return dispatcher::dispatch<shared_buffer_factory>(s);
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace saco::detail
-
-namespace saco {
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T, class... Args>
-std::shared_ptr<T> build_shared(Args&&... args) {
-	static_assert(alignof(T) <= detail::MAX_NEW_ALIGNMENT);
-	// measure
-	measure_context mctx;
-	saco::place<T>(mctx, std::as_const(args)...);
-
-	// check size limit & allocate memory
-	std::size_t const alloc_size = mctx.required_size();
-	if (alloc_size > detail::shared_alloc_impl::MAX_SIZE)
-		return build_unique<T>(std::forward<Args>(args)...);
-	std::shared_ptr<detail::shared_buffer_header> sp = detail::shared_alloc_impl::alloc(alloc_size);
-
-	// construct
-	construct_context cctx{sp->object, alloc_size};
-	[[maybe_unused]] auto const original_address = sp->object;
-	sp->object = saco::place<T>(cctx, std::forward<Args>(args)...);
-	detail::set_dtor_fn_impl<std::has_virtual_destructor_v<T>>::template set_dtor_fn<T>(*sp);
-	SACO_ASSERT(sp->object == original_address);
-	return std::shared_ptr<T>(std::move(sp), static_cast<T*>(sp->object));
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace saco
+#pragma once
+
+#include <saco/saco.h>
+#include <saco/xsize_dispatcher.h>
+#include <saco/xthread_cache.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct shared_buffer_header {
+	explicit shared_buffer_header(void* object) : dtor_fn{nullptr}, object{object} {
+	}
+
+	~shared_buffer_header() {
+		if (dtor_fn)
+			dtor_fn(object);
+	}
+
+	void (*dtor_fn)(void*);
+	void* object;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <bool HAS_TRIVIAL_DTOR>
+struct set_dtor_fn_impl;
+
+template <>
+struct set_dtor_fn_impl<true> {
+	template <class T, class Buffer>
+	static void set_dtor_fn(Buffer&) {
+		// no need to call trivial dtor
+	}
+};
+
+template <>
+struct set_dtor_fn_impl<false> {
+	template <class T, class Buffer>
+	static void set_dtor_fn(Buffer& buffer) {
+		buffer.dtor_fn = &detail::call_dtor<T>;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t N, std::size_t ALIGN = MAX_NEW_ALIGNMENT>
+struct shared_buffer : shared_buffer_header {
+	shared_buffer() : shared_buffer_header(&storage) {
+	}
+
+	alignas(ALIGN) byte storage[N];
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct trailing_storage_request {
+	std::size_t size;
+	void* storage;
+
+	// request of the allocate_shared call in progress on this thread, see trailing_storage_allocator
+	static inline thread_local trailing_storage_request* tls_current{nullptr};
+};
+
+// Stateless allocator used with std::allocate_shared to append exactly `size` bytes of storage to the control block,
+// as requested by trailing_storage_request::tls_current. allocate reports the address of the storage back through the
+// request. This is fine because allocate_shared calls allocate exactly once, on the calling thread, and deallocate
+// doesn't need the request. Being stateless, the allocator takes no space in the control block.
+template <class T, std::size_t ALIGN>
+class trailing_storage_allocator {
+public:
+	using value_type = T;
+
+	template <class U>
+	struct rebind {
+		using other = trailing_storage_allocator<U, ALIGN>;
+	};
+
+	trailing_storage_allocator() = default;
+
+	template <class U>
+	trailing_storage_allocator(trailing_storage_allocator<U, ALIGN> const&) {
+	}
+
+	T* allocate(std::size_t n) {
+		trailing_storage_request* const request = std::exchange(trailing_storage_request::tls_current, nullptr);
+		SACO_ASSERT(request);
+		std::size_t const storage_offset = align<ALIGN>(n * sizeof(T));
+		auto const p = static_cast<byte*>(alloc_raw<BLOCK_ALIGN>(storage_offset + request->size));
+		request->storage = p + storage_offset;
+		return reinterpret_cast<T*>(p);
+	}
+
+	void deallocate(T* p, std::size_t) {
+		free_raw<BLOCK_ALIGN>(p);
+	}
+
+	template <class U>
+	bool operator==(trailing_storage_allocator<U, ALIGN> const&) const {
+		return true;
+	}
+
+	template <class U>
+	bool operator!=(trailing_storage_allocator<U, ALIGN> const&) const {
+		return false;
+	}
+
+private:
+	static constexpr std::size_t BLOCK_ALIGN = alignof(T) > ALIGN ? alignof(T) : ALIGN;
+};
+
+// Payload of the control blocks of alloc_exact, which only holds the destructor thunk. The storage always lies at the
+// same distance from the payload, as all control blocks of a given ALIGN have the same type and thus the same layout,
+// so the distance is kept once per ALIGN instead of an object pointer per block.
+template <std::size_t ALIGN>
+struct trailing_shared_buffer {
+	// only called after trailing_storage_allocator::allocate has stored the address of the storage
+	explicit trailing_shared_buffer(trailing_storage_request const* request) : dtor_fn{nullptr} {
+		std::ptrdiff_t const offset = static_cast<byte*>(request->storage) - reinterpret_cast<byte*>(this);
+		// only the first blocks write, afterwards the cache line stays shared between the cores
+		std::ptrdiff_t const known = s_storage_offset.load(std::memory_order_relaxed);
+		if (SACO_UNLIKELY(known == 0))
+			s_storage_offset.store(offset, std::memory_order_relaxed);
+		else
+			SACO_ASSERT(known == offset);
+	}
+
+	~trailing_shared_buffer() {
+		if (dtor_fn)
+			dtor_fn(storage());
+	}
+
+	void* storage() {
+		return reinterpret_cast<byte*>(this) + s_storage_offset.load(std::memory_order_relaxed);
+	}
+
+	void (*dtor_fn)(void*);
+
+private:
+	// Written by the first constructors (all with the same value), read by the destructor. The reference counting of
+	// std::shared_ptr orders the destruction after the construction of the same block, which saw the offset already.
+	static inline std::atomic<std::ptrdiff_t> s_storage_offset{0};
+};
+
+inline void* buffer_storage(shared_buffer_header& buffer) {
+	return buffer.object;
+}
+
+template <std::size_t ALIGN>
+void* buffer_storage(trailing_shared_buffer<ALIGN>& buffer) {
+	return buffer.storage();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct shared_alloc_impl {
+	template <std::size_t ALIGN>
+	struct shared_buffer_factory {
+		template <std::size_t OBJECT_SIZE>
+		struct fn {
+			std::shared_ptr<shared_buffer_header> operator()() const {
+#if SACO_SHARED_THREAD_CACHE
+				return (*this)(thread_cache_allocator<byte>{});
+#else
+				if SACO_IF_CONSTEXPR (OBJECT_SIZE > 0)
+					return std::make_shared<shared_buffer<OBJECT_SIZE, ALIGN>>();
+				else
+					return std::make_shared<shared_buffer<1, ALIGN>>();
+#endif
+			}
+
+			template <class Alloc>
+			std::shared_ptr<shared_buffer_header> operator()(Alloc const& alloc) const {
+				if SACO_IF_CONSTEXPR (OBJECT_SIZE > 0)
+					return std::allocate_shared<shared_buffer<OBJECT_SIZE, ALIGN>>(alloc);
+				else
+					return std::allocate_shared<shared_buffer<1, ALIGN>>(alloc);
+			}
+		};
+	};
+
+	// small sizes are dispatched as configured by SACO_SIZE_DISPATCHER, larger ones through a jump table
+#if SACO_SIZE_DISPATCHER == SACO_SIZE_DISPATCHER_SWITCH
+	using dispatcher = size_dispatcher_switch;
+#elif SACO_SIZE_DISPATCHER == SACO_SIZE_DISPATCHER_NESTED_IF
+	using dispatcher = size_dispatcher_nested_if;
+#else
+#error "unknown SACO_SIZE_DISPATCHER"
+#endif
+	using large_dispatcher = size_dispatcher_geometric<std::size_t{1} << 20>;
+	static constexpr std::size_t MAX_SIZE = large_dispatcher::MAX_SIZE;
+
+	template <std::size_t ALIGN = MAX_NEW_ALIGNMENT, class... Alloc>
+	static SACO_NOINLINE std::shared_ptr<shared_buffer_header> alloc(std::size_t s, Alloc const&... alloc) {
+		static_assert(sizeof...(Alloc) <= 1);
+		if (SACO_LIKELY(s <= dispatcher::MAX_SIZE))
+			return dispatcher::dispatch<shared_buffer_factory<ALIGN>::template fn>(s, alloc...);
+		else
+			return large_dispatcher::dispatch<shared_buffer_factory<ALIGN>::template fn>(s, alloc...);
+	}
+
+	template <std::size_t OBJECT_SIZE>
+	struct size_class_fn {
+		std::size_t operator()() const {
+			return OBJECT_SIZE > 0 ? OBJECT_SIZE : 1;
+		}
+	};
+
+	// Size of the storage that alloc(s) hands out, i.e. `s` rounded up to its size class.
+	static std::size_t size_class(std::size_t s) {
+		if (s <= dispatcher::MAX_SIZE)
+			return dispatcher::dispatch<size_class_fn>(s);
+		else
+			return large_dispatcher::dispatch<size_class_fn>(s);
+	}
+
+	// For sizes that are known at compile time.
+	template <std::size_t SIZE, std::size_t ALIGN = MAX_NEW_ALIGNMENT>
+	static std::shared_ptr<shared_buffer_header> alloc_static() {
+		return typename shared_buffer_factory<ALIGN>::template fn<SIZE>{}();
+	}
+
+	// Allocates exactly `s` bytes of storage behind the control block, no matter how large `s` is.
+	template <std::size_t ALIGN = MAX_NEW_ALIGNMENT>
+	static SACO_NOINLINE std::shared_ptr<trailing_shared_buffer<ALIGN>> alloc_exact(std::size_t s) {
+		trailing_storage_request request{s, nullptr};
+		trailing_storage_request::tls_current = &request;
+		using buffer = trailing_shared_buffer<ALIGN>;
+		return std::allocate_shared<buffer>(trailing_storage_allocator<buffer, ALIGN>{}, &request);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Records a build of T into storage from shared_alloc_impl::alloc, or from alloc_exact if the block is too large.
+template <class T>
+SACO_ALWAYS_INLINE void record_shared_build(
+		[[maybe_unused]] std::size_t block_size,
+		[[maybe_unused]] std::size_t padding) {
+#if defined(SACO_STATS)
+	std::size_t const allocated_size =
+			block_size <= shared_alloc_impl::MAX_SIZE ? shared_alloc_impl::size_class(block_size) : block_size;
+	record_build<T>(block_size, padding, allocated_size);
+#endif
+}
+
+template <class T, class Context, class Buffer, class... Args>
+std::shared_ptr<T> construct_shared(std::shared_ptr<Buffer> sp, std::size_t size, Args&&... args) {
+	void* const storage = buffer_storage(*sp);
+	Context cctx{storage, size};
+	T* const obj = saco::place<T>(cctx, std::forward<Args>(args)...);
+	set_dtor_fn_impl<std::is_trivially_destructible_v<T>>::template set_dtor_fn<T>(*sp);
+	SACO_ASSERT(obj == storage);
+	return std::shared_ptr<T>(std::move(sp), obj);
+}
+
+// Constructs T into `size` bytes of storage, rounded up to a size class if it has one or of exactly that size if not.
+template <class T, class Context, std::size_t ALIGN, class... Args>
+std::shared_ptr<T> alloc_and_construct_shared(std::size_t size, Args&&... args) {
+	if (SACO_LIKELY(size <= shared_alloc_impl::MAX_SIZE))
+		return construct_shared<T, Context>(shared_alloc_impl::alloc<ALIGN>(size), size, std::forward<Args>(args)...);
+	else
+		return construct_shared<T, Context>(
+				shared_alloc_impl::alloc_exact<ALIGN>(size), size, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds the object in a single pass, without measuring it first.
+// `max_size` must be an upper bound for the size that would have been measured, otherwise std::length_error is thrown.
+template <class T, class... Args>
+std::shared_ptr<T> build_shared_bounded(std::size_t max_size, Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	// the root alone would not fit, and the size dispatcher does not accept 0
+	if (SACO_UNLIKELY(max_size < sizeof(T)))
+		detail::throw_size_bound_exceeded();
+
+	// allocate memory & construct
+	using context = checked_construct_context;
+	auto obj = detail::alloc_and_construct_shared<T, context, ALIGN>(max_size, std::forward<Args>(args)...);
+	detail::record_shared_build<T>(max_size, 0);
+	return obj;
+}
+
+template <class T, class... Args>
+std::shared_ptr<T> build_shared(Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	if SACO_IF_CONSTEXPR (detail::has_static_layout_v<T>) {
+		// the size is known at compile time, no need to measure or to dispatch on the size
+		static constexpr std::size_t SIZE = detail::static_size_v<T>;
+		std::shared_ptr<detail::shared_buffer_header> sp = detail::shared_alloc_impl::alloc_static<SIZE, ALIGN>();
+		auto obj = detail::construct_shared<T, construct_context>(std::move(sp), SIZE, std::forward<Args>(args)...);
+		detail::record_build<T>(SIZE, detail::static_padding_v<T>, SIZE > 0 ? SIZE : 1);
+		return obj;
+	}
+	if SACO_IF_CONSTEXPR (detail::has_max_size_v<T, Args...>) {
+		std::size_t const max_size = builder<T>::max_size(std::as_const(args)...);
+		return build_shared_bounded<T>(max_size, std::forward<Args>(args)...);
+	}
+
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+
+	// allocate memory & construct
+	std::size_t const alloc_size = mctx.required_size();
+	using context = construct_context;
+	auto obj = detail::alloc_and_construct_shared<T, context, ALIGN>(alloc_size, std::forward<Args>(args)...);
+	detail::record_shared_build<T>(alloc_size, mctx.padding_size());
+	return obj;
+}
+
+// Like build_shared, but places the object in storage of exactly the measured size behind the control block instead of
+// rounding up to the next size class. Trades the slack of the size classes for a less predictable allocation size.
+template <class T, class... Args>
+std::shared_ptr<T> build_shared_exact(Args&&... args) {
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+
+	// allocate memory
+	std::size_t const alloc_size = mctx.required_size();
+	auto sp = detail::shared_alloc_impl::alloc_exact<ALIGN>(alloc_size);
+
+	// construct
+	auto obj = detail::construct_shared<T, construct_context>(std::move(sp), alloc_size, std::forward<Args>(args)...);
+	detail::record_build<T>(alloc_size, mctx.padding_size(), alloc_size);
+	return obj;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reference count policies for shared_ref.
+
+struct atomic_counter {
+	using type = std::atomic<std::size_t>;
+
+	static void increment(type& count) {
+		count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// returns true if the count dropped to zero
+	static bool decrement(type& count) {
+		return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	static std::size_t load(type const& count) {
+		return count.load(std::memory_order_relaxed);
+	}
+};
+
+struct nonatomic_counter {
+	using type = std::size_t;
+
+	static void increment(type& count) {
+		++count;
+	}
+
+	// returns true if the count dropped to zero
+	static bool decrement(type& count) {
+		return --count == 0;
+	}
+
+	static std::size_t load(type const& count) {
+		return count;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+template <class Counter>
+struct ref_header {
+	typename Counter::type count;
+};
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reference counted handle to a saco object, with the reference count stored in the object's block.
+// Unlike std::shared_ptr there is no separate control block pointer, so a handle is the size of a plain pointer, and
+// with nonatomic_counter copies don't need atomic instructions. Weak references are not supported.
+template <class T, class Counter = atomic_counter>
+class shared_ref {
+	using header = detail::ref_header<Counter>;
+
+public:
+	using element_type = T;
+
+	static constexpr std::size_t BLOCK_ALIGNMENT = detail::root_alignment_v<T>;
+	static constexpr std::size_t OBJECT_OFFSET = detail::align<alignof(T)>(sizeof(header));
+
+	shared_ref() = default;
+
+	shared_ref(shared_ref const& other) : m_object{other.m_object} {
+		if (m_object)
+			Counter::increment(get_header()->count);
+	}
+
+	shared_ref(shared_ref&& other) noexcept : m_object{std::exchange(other.m_object, nullptr)} {
+	}
+
+	~shared_ref() {
+		if (m_object)
+			release();
+	}
+
+	shared_ref& operator=(shared_ref const& other) {
+		shared_ref(other).swap(*this);
+		return *this;
+	}
+
+	shared_ref& operator=(shared_ref&& other) noexcept {
+		shared_ref(std::move(other)).swap(*this);
+		return *this;
+	}
+
+	void reset() {
+		shared_ref().swap(*this);
+	}
+
+	void swap(shared_ref& other) noexcept {
+		std::swap(m_object, other.m_object);
+	}
+
+	T* get() const {
+		return m_object;
+	}
+
+	T& operator*() const {
+		return *m_object;
+	}
+
+	T* operator->() const {
+		return m_object;
+	}
+
+	explicit operator bool() const {
+		return m_object != nullptr;
+	}
+
+	std::size_t use_count() const {
+		return m_object ? Counter::load(get_header()->count) : 0;
+	}
+
+	friend bool operator==(shared_ref const& a, shared_ref const& b) {
+		return a.m_object == b.m_object;
+	}
+
+	friend bool operator!=(shared_ref const& a, shared_ref const& b) {
+		return a.m_object != b.m_object;
+	}
+
+	// Takes ownership of an object constructed OBJECT_OFFSET bytes into a block with an initialized header.
+	// Used by build_ref, not meant to be called directly.
+	static shared_ref adopt(T* object) {
+		shared_ref ref;
+		ref.m_object = object;
+		return ref;
+	}
+
+private:
+	header* get_header() const {
+		return reinterpret_cast<header*>(reinterpret_cast<byte*>(m_object) - OBJECT_OFFSET);
+	}
+
+	SACO_NOINLINE void release() {
+		header* const h = get_header();
+		if (Counter::decrement(h->count)) {
+			m_object->~T();
+			h->~header();
+			detail::free_raw<BLOCK_ALIGNMENT>(h);
+		}
+	}
+
+	T* m_object{nullptr};
+};
+
+template <class T>
+using local_shared_ref = shared_ref<T, nonatomic_counter>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, class Counter = atomic_counter, class... Args>
+shared_ref<T, Counter> build_ref(Args&&... args) {
+	using ref_type = shared_ref<T, Counter>;
+	using header = detail::ref_header<Counter>;
+	static constexpr std::size_t ALIGN = ref_type::BLOCK_ALIGNMENT;
+
+	// measure
+	measure_context mctx{ALIGN};
+	mctx.allocate_space<header>();
+	saco::place<T>(mctx, std::as_const(args)...);
+	std::size_t const required_size = mctx.required_size();
+
+	// allocate raw memory
+	std::unique_ptr<void, detail::aligned_raw_delete<ALIGN>> raw_memory(detail::alloc_raw<ALIGN>(required_size));
+
+	// construct
+	construct_context cctx{raw_memory.get(), required_size};
+	[[maybe_unused]] auto const h = ::new (cctx.allocate_space<header>()) header{{1}};
+	SACO_ASSERT(static_cast<void*>(h) == raw_memory.get());
+	T* const obj = saco::place<T>(cctx, std::forward<Args>(args)...);
+	SACO_ASSERT(reinterpret_cast<byte*>(obj) == static_cast<byte*>(raw_memory.get()) + ref_type::OBJECT_OFFSET);
+	raw_memory.release();
+	return ref_type::adopt(obj);
+}
+
+template <class T, class... Args>
+local_shared_ref<T> build_local_ref(Args&&... args) {
+	return build_ref<T, nonatomic_counter>(std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <saco/image.h>
+#include <saco/offset_ptr.h>
+#include <saco/saco.h>
+#include <saco/ximage.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Note: with glibc before 2.34, shm_open and shm_unlink live in librt.
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// The magic is the first word of an image. build_shm publishes it with a release store once everything else has been
+// written, attach_shm checks it with an acquire load before reading anything else. Mappings are page aligned, so the
+// word is naturally aligned. It is never written again after it has been published.
+static_assert(offsetof(image_header, magic) == 0);
+static_assert(sizeof(image_header::magic) == sizeof(std::uint64_t));
+
+inline std::uint64_t image_magic_word() {
+	std::uint64_t word;
+	std::memcpy(&word, IMAGE_MAGIC, sizeof(word));
+	return word;
+}
+
+inline void publish_image_magic(void* mapping) {
+	__atomic_store_n(static_cast<std::uint64_t*>(mapping), image_magic_word(), __ATOMIC_RELEASE);
+}
+
+inline bool image_magic_published(void const* mapping) {
+	return __atomic_load_n(static_cast<std::uint64_t const*>(mapping), __ATOMIC_ACQUIRE) == image_magic_word();
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds a relocatable object directly in a new POSIX shared memory object `name` (e.g. "/routes").
+//
+// The object is measured first, so the segment is created with exactly the size of the image, then the object is
+// constructed in place. The image header is the same as for saco::save, its magic is written last, so processes that
+// attach while the object is still being built fail cleanly instead of seeing a partially constructed object.
+// Throws std::system_error if the segment already exists.
+//
+// The returned handle only keeps the segment mapped, the segment itself lives until it is removed with unlink_shm.
+// Objects in shared memory are never destroyed.
+template <class T, class... Args>
+mapped_ptr<T> build_shm(std::string const& name, Args&&... args) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+	static constexpr std::size_t ALIGN = detail::root_alignment_v<T>;
+	static constexpr std::size_t PAYLOAD_OFFSET = detail::image_payload_offset_v<T>;
+
+	// measure
+	measure_context mctx{ALIGN};
+	saco::place<T>(mctx, std::as_const(args)...);
+	std::size_t const required_size = mctx.required_size();
+	std::size_t const image_size = PAYLOAD_OFFSET + required_size;
+
+	// allocate shared memory
+	detail::file_descriptor fd{::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644)};
+	if (fd.get() < 0)
+		detail::throw_errno("saco: shm_open");
+
+	void* mapping = MAP_FAILED;
+	try {
+		if (::ftruncate(fd.get(), static_cast<off_t>(image_size)) != 0)
+			detail::throw_errno("saco: ftruncate");
+		mapping = ::mmap(nullptr, image_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+		if (mapping == MAP_FAILED)
+			detail::throw_errno("saco: mmap");
+
+		// construct
+		void* const payload = static_cast<byte*>(mapping) + PAYLOAD_OFFSET;
+		construct_context cctx{payload, required_size};
+		T* const obj = saco::place<T>(cctx, std::forward<Args>(args)...);
+		SACO_ASSERT(obj == payload);
+
+		// publish: the header behind the magic first, then the magic
+		detail::image_header const header = detail::make_image_header<T>(obj, required_size);
+		constexpr std::size_t MAGIC_SIZE = sizeof(header.magic);
+		std::memcpy(
+				static_cast<byte*>(mapping) + MAGIC_SIZE,
+				reinterpret_cast<byte const*>(&header) + MAGIC_SIZE,
+				sizeof(header) - MAGIC_SIZE);
+		detail::publish_image_magic(mapping);
+
+		return mapped_ptr<T>::adopt(mapping, image_size, obj, required_size);
+	} catch (...) {
+		if (mapping != MAP_FAILED)
+			::munmap(mapping, image_size);
+		::shm_unlink(name.c_str());
+		throw;
+	}
+}
+
+// Attaches read-only to an object built with build_shm, possibly in another process. All processes share the same
+// physical pages. Throws std::system_error if the segment does not exist and std::runtime_error if it does not hold a
+// (completely built) object of T.
+template <class T>
+mapped_ptr<T> attach_shm(std::string const& name, bool verify_checksum = true) {
+	static_assert(is_relocatable_v<T>, "type must be marked relocatable, see saco::is_relocatable");
+
+	detail::file_descriptor fd{::shm_open(name.c_str(), O_RDONLY, 0)};
+	if (fd.get() < 0)
+		detail::throw_errno("saco: shm_open");
+
+	struct stat st;
+	if (::fstat(fd.get(), &st) != 0)
+		detail::throw_errno("saco: fstat");
+	auto const size = static_cast<std::size_t>(st.st_size);
+	if (size < sizeof(detail::image_header))
+		detail::throw_invalid_image("too small");
+
+	void* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0);
+	if (mapping == MAP_FAILED)
+		detail::throw_errno("saco: mmap");
+
+	try {
+		// the rest of the image may only be read after the magic
+		if (!detail::image_magic_published(mapping))
+			detail::throw_invalid_image("bad magic");
+
+		detail::image_header const header = detail::check_image<T>(mapping, size, verify_checksum);
+		auto const obj = reinterpret_cast<T const*>(static_cast<byte const*>(mapping) + header.payload_offset);
+		return mapped_ptr<T>::adopt(mapping, size, obj, static_cast<std::size_t>(header.payload_size));
+	} catch (...) {
+		::munmap(mapping, size);
+		throw;
+	}
+}
+
+// Removes the name of a segment created by build_shm. Processes that are still attached keep their mapping.
+// Returns false if there was no such segment.
+inline bool unlink_shm(std::string const& name) {
+	return ::shm_unlink(name.c_str()) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
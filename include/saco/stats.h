@@ -0,0 +1,88 @@
+#pragma once
+
+#include <saco/saco.h>
+#include <saco/xstats.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Whether the build functions record statistics, see SACO_STATS in saco/xstats.h.
+inline constexpr bool STATS_ENABLED = detail::STATS_ENABLED;
+
+// Statistics of the objects built by build_unique, build_shared and their _bounded, _exact and _with variants.
+// Sizes don't include control blocks of std::shared_ptr nor the bookkeeping of the underlying allocator.
+struct build_stats {
+	std::size_t builds{0};
+	// sum of the sizes of the blocks the objects were constructed in (the bound for _bounded builds)
+	std::size_t block_bytes{0};
+	// part of block_bytes that is alignment padding (zero for _bounded builds, which are not measured)
+	std::size_t padding_bytes{0};
+	// sum of the sizes of the allocations that held the blocks
+	std::size_t allocated_bytes{0};
+
+	// bytes lost to rounding blocks up to the size classes of build_shared (or to allocation units)
+	std::size_t slack_bytes() const {
+		return allocated_bytes - block_bytes;
+	}
+
+	build_stats& operator+=(build_stats const& other) {
+		builds += other.builds;
+		block_bytes += other.block_bytes;
+		padding_bytes += other.padding_bytes;
+		allocated_bytes += other.allocated_bytes;
+		return *this;
+	}
+};
+
+struct type_build_stats {
+	// implementation defined name of the root type (std::type_info::name, or the function signature without RTTI)
+	char const* type_name;
+	build_stats stats;
+};
+
+namespace detail {
+
+inline build_stats load_stats(type_stats const& counters) {
+	build_stats stats;
+	stats.builds = counters.builds.load(std::memory_order_relaxed);
+	stats.block_bytes = counters.block_bytes.load(std::memory_order_relaxed);
+	stats.padding_bytes = counters.padding_bytes.load(std::memory_order_relaxed);
+	stats.allocated_bytes = counters.allocated_bytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+} // namespace detail
+
+// Statistics of the objects of root type T built so far. The counters are updated independently, so a snapshot taken
+// while other threads are building objects may be slightly inconsistent.
+template <class T>
+build_stats stats() {
+	return detail::load_stats(detail::type_stats_of<T>());
+}
+
+// Statistics of all root types that have been built so far (or that stats<T>() was called for).
+inline std::vector<type_build_stats> stats_snapshot() {
+	std::vector<type_build_stats> snapshot;
+	for (auto p = detail::g_type_stats_head.load(std::memory_order_acquire); p; p = p->next)
+		snapshot.push_back({p->type_name, detail::load_stats(*p)});
+	return snapshot;
+}
+
+// Resets the statistics of all types to zero.
+inline void reset_stats() {
+	for (auto p = detail::g_type_stats_head.load(std::memory_order_acquire); p; p = p->next) {
+		p->builds.store(0, std::memory_order_relaxed);
+		p->block_bytes.store(0, std::memory_order_relaxed);
+		p->padding_bytes.store(0, std::memory_order_relaxed);
+		p->allocated_bytes.store(0, std::memory_order_relaxed);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
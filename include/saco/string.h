@@ -0,0 +1,211 @@
+#pragma once
+
+#include <saco/saco.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Copies the characters into the block and returns a view of the copy. The copy is not NUL-terminated.
+template <class Char, class Traits, class Context>
+std::basic_string_view<Char, Traits> place_string_view(Context& ctx, std::basic_string_view<Char, Traits> sv) {
+	[[maybe_unused]] Char* const mem = saco::place_for_overwrite<Char[]>(sv.size(), ctx);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		if (sv.empty())
+			return {};
+		Traits::copy(mem, sv.data(), sv.size());
+		return {mem, sv.size()};
+	} else {
+		return {};
+	}
+}
+
+template <class Char, class Traits, class Alloc, class Context>
+std::basic_string_view<Char, Traits> place_string_view(
+		Context& ctx,
+		std::basic_string<Char, Traits, Alloc> const& str) {
+	return saco::place_string_view(ctx, std::basic_string_view<Char, Traits>(str));
+}
+
+template <class Char, class Context>
+std::basic_string_view<Char> place_string_view(Context& ctx, Char const* str) {
+	return saco::place_string_view(ctx, str ? std::basic_string_view<Char>{str} : std::basic_string_view<Char>());
+}
+
+template <class Char, class Context>
+std::basic_string_view<Char> place_string_view(Context& ctx, Char const* data, std::size_t count) {
+	return saco::place_string_view(ctx, std::basic_string_view<Char>{data, count});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Copies the characters into the block and appends a NUL terminator.
+template <class Char, class Traits, class Context>
+Char const* place_c_str(Context& ctx, std::basic_string_view<Char, Traits> sv) {
+	[[maybe_unused]] Char* const mem = saco::place_for_overwrite<Char[]>(sv.size() + 1, ctx);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		Traits::copy(mem, sv.data(), sv.size());
+		Traits::assign(mem[sv.size()], Char());
+		return mem;
+	} else {
+		return nullptr;
+	}
+}
+
+template <class Char, class Traits, class Alloc, class Context>
+Char const* place_c_str(Context& ctx, std::basic_string<Char, Traits, Alloc> const& str) {
+	return saco::place_c_str(ctx, std::basic_string_view<Char, Traits>(str));
+}
+
+template <class Char, class Context>
+Char const* place_c_str(Context& ctx, Char const* str) {
+	return saco::place_c_str(ctx, str ? std::basic_string_view<Char>{str} : std::basic_string_view<Char>());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+SACO_ALWAYS_INLINE std::size_t varint_size(std::size_t value) {
+	std::size_t n = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		n++;
+	}
+	return n;
+}
+
+// Writes the value as LEB128 backwards, ending right before `end`.
+SACO_ALWAYS_INLINE void write_reverse_varint(unsigned char* end, std::size_t value) {
+	for (;;) {
+		auto const bits = static_cast<unsigned char>(value & 0x7F);
+		value >>= 7;
+		*--end = value ? static_cast<unsigned char>(bits | 0x80) : bits;
+		if (!value)
+			return;
+	}
+}
+
+SACO_ALWAYS_INLINE std::size_t read_reverse_varint(unsigned char const* end) {
+	std::size_t value = 0;
+	for (unsigned shift = 0;; shift += 7) {
+		unsigned char const b = *--end;
+		value |= static_cast<std::size_t>(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return value;
+	}
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Pointer-sized handle to an immutable string stored in a saco block, with its length stored in the block as well.
+//
+// The length is stored right in front of the characters as a variable length integer (1 byte for up to 127
+// characters), so a short key costs one byte of overhead plus the handle, instead of a size field plus a NUL
+// terminator. Empty strings are not stored at all.
+template <class Char, class Traits = std::char_traits<Char>>
+class basic_inline_string {
+public:
+	using value_type = Char;
+	using traits_type = Traits;
+	using size_type = std::size_t;
+	using const_iterator = Char const*;
+	using view_type = std::basic_string_view<Char, Traits>;
+
+	basic_inline_string() = default;
+
+	Char const* data() const {
+		return m_data;
+	}
+
+	size_type size() const {
+		return m_data ? detail::read_reverse_varint(reinterpret_cast<unsigned char const*>(m_data)) : 0;
+	}
+
+	bool empty() const {
+		return m_data == nullptr;
+	}
+
+	const_iterator begin() const {
+		return m_data;
+	}
+
+	const_iterator end() const {
+		return m_data + size();
+	}
+
+	view_type view() const {
+		return m_data ? view_type{m_data, size()} : view_type{};
+	}
+
+	operator view_type() const {
+		return view();
+	}
+
+	friend bool operator==(basic_inline_string const& a, basic_inline_string const& b) {
+		return a.view() == b.view();
+	}
+
+	friend bool operator!=(basic_inline_string const& a, basic_inline_string const& b) {
+		return a.view() != b.view();
+	}
+
+	template <class Context>
+	static basic_inline_string place(Context& ctx, view_type sv) {
+		if (sv.empty())
+			return {};
+
+		// length prefix, padded in front to keep the characters aligned
+		std::size_t const prefix_size = detail::varint_size(sv.size());
+		std::size_t const prefix_chars = (prefix_size + sizeof(Char) - 1) / sizeof(Char);
+
+		[[maybe_unused]] Char* const mem = saco::place_for_overwrite<Char[]>(prefix_chars + sv.size(), ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			Char* const chars = mem + prefix_chars;
+			detail::write_reverse_varint(reinterpret_cast<unsigned char*>(chars), sv.size());
+			Traits::copy(chars, sv.data(), sv.size());
+			basic_inline_string result;
+			result.m_data = chars;
+			return result;
+		} else {
+			return {};
+		}
+	}
+
+private:
+	Char const* m_data{nullptr};
+};
+
+using inline_string = basic_inline_string<char>;
+using inline_wstring = basic_inline_string<wchar_t>;
+
+template <class Char, class Traits, class Context>
+basic_inline_string<Char, Traits> place_inline_string(Context& ctx, std::basic_string_view<Char, Traits> sv) {
+	return basic_inline_string<Char, Traits>::place(ctx, sv);
+}
+
+template <class Char, class Traits, class Alloc, class Context>
+basic_inline_string<Char, Traits> place_inline_string(
+		Context& ctx,
+		std::basic_string<Char, Traits, Alloc> const& str) {
+	return basic_inline_string<Char, Traits>::place(ctx, str);
+}
+
+template <class Char, class Context>
+basic_inline_string<Char> place_inline_string(Context& ctx, Char const* str) {
+	return saco::place_inline_string(ctx, str ? std::basic_string_view<Char>{str} : std::basic_string_view<Char>());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <saco/allocator.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/xthread_cache.h>
+
+#include <memory>
+#include <utility>
+
+namespace saco {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Stateless allocator that recycles blocks through the calling thread's cache, see detail::thread_cache_allocator.
+template <class T>
+using thread_cache_allocator = detail::thread_cache_allocator<T>;
+
+template <class T>
+using cached_unique_ptr = allocator_unique_ptr<T, thread_cache_allocator<byte>>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, class... Args>
+cached_unique_ptr<T> build_unique_cached(Args&&... args) {
+	return build_unique_with<T>(thread_cache_allocator<byte>{}, std::forward<Args>(args)...);
+}
+
+template <class T, class... Args>
+std::shared_ptr<T> build_shared_cached(Args&&... args) {
+	return build_shared_with<T>(thread_cache_allocator<byte>{}, std::forward<Args>(args)...);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco
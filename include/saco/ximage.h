@@ -0,0 +1,113 @@
+#pragma once
+
+#include <saco/xcore.h>
+#include <saco/xutility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Header in front of a relocatable saco block that is stored outside of the process (file, shared memory).
+// The payload starts at `payload_offset`, which keeps it aligned for the root type as long as the image itself is
+// page aligned.
+struct image_header {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	std::uint64_t type_size;
+	std::uint64_t type_alignment;
+	std::uint64_t payload_offset;
+	std::uint64_t payload_size;
+	std::uint64_t checksum;
+};
+
+inline constexpr char IMAGE_MAGIC[8] = {'S', 'A', 'C', 'O', 'I', 'M', 'G', '\0'};
+inline constexpr std::uint32_t IMAGE_VERSION = 1;
+inline constexpr std::uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+
+// Smallest page size of the supported platforms, images are mapped at page boundaries.
+inline constexpr std::size_t IMAGE_BASE_ALIGNMENT = 4096;
+
+template <class T>
+inline constexpr std::size_t image_payload_offset_v = align<root_alignment_v<T>>(sizeof(image_header));
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// 64 bit FNV-1a over 8 byte words, good enough to detect truncated or corrupted images.
+inline std::uint64_t image_checksum(void const* data, std::size_t size) {
+	constexpr std::uint64_t PRIME = 0x100000001b3;
+	std::uint64_t hash = 0xcbf29ce484222325;
+
+	auto const bytes = static_cast<unsigned char const*>(data);
+	std::size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * PRIME;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ bytes[i]) * PRIME;
+	return hash;
+}
+
+template <class T>
+image_header make_image_header(void const* payload, std::size_t payload_size) {
+	image_header header{};
+	std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+	header.version = IMAGE_VERSION;
+	header.byte_order = IMAGE_BYTE_ORDER;
+	header.type_size = sizeof(T);
+	header.type_alignment = alignof(T);
+	header.payload_offset = image_payload_offset_v<T>;
+	header.payload_size = payload_size;
+	header.checksum = image_checksum(payload, payload_size);
+	return header;
+}
+
+[[noreturn]] inline SACO_NOINLINE void throw_invalid_image(char const* reason) {
+	throw std::runtime_error(std::string("saco: invalid image: ") + reason);
+}
+
+// Checks that `image` (`image_size` bytes, including the header) holds a block that was saved for T and returns its
+// header. The payload is only checksummed when `verify_checksum` is set, as that reads all of it.
+template <class T>
+image_header check_image(void const* image, std::size_t image_size, bool verify_checksum) {
+	static_assert(root_alignment_v<T> <= IMAGE_BASE_ALIGNMENT);
+
+	if (image_size < sizeof(image_header))
+		throw_invalid_image("too small");
+
+	image_header header;
+	std::memcpy(&header, image, sizeof(header));
+
+	if (std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+		throw_invalid_image("bad magic");
+	if (header.version != IMAGE_VERSION)
+		throw_invalid_image("unsupported version");
+	if (header.byte_order != IMAGE_BYTE_ORDER)
+		throw_invalid_image("byte order mismatch");
+	if (header.type_size != sizeof(T) || header.type_alignment != alignof(T))
+		throw_invalid_image("type mismatch");
+	if (header.payload_offset != image_payload_offset_v<T>)
+		throw_invalid_image("bad payload offset");
+	if (image_size < header.payload_offset || header.payload_size > image_size - header.payload_offset)
+		throw_invalid_image("truncated");
+	if (header.payload_size < sizeof(T))
+		throw_invalid_image("payload too small");
+
+	auto const payload = static_cast<byte const*>(image) + header.payload_offset;
+	if (verify_checksum && image_checksum(payload, header.payload_size) != header.checksum)
+		throw_invalid_image("checksum mismatch");
+
+	return header;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
@@ -1,167 +1,248 @@
-#pragma once
-
-#include <saco/xcore.h>
-
-#include <cstdint>
-
-#if defined(_MSC_VER)
-#include <intrin.h>
-#endif
-
-namespace saco::detail {
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-#if defined(_MSC_VER)
-
-#define SACO_HAVE_BSR_INTRIN
-SACO_ALWAYS_INLINE unsigned bsr_intrin(unsigned s) {
-	unsigned long index;
-	_BitScanReverse(&index, s);
-	return static_cast<unsigned>(index);
-}
-
-#elif defined(__GNUC__) || defined(__clang__)
-
-#define SACO_HAVE_BSR_INTRIN
-SACO_ALWAYS_INLINE unsigned bsr_intrin(unsigned s) {
-	return 31u - static_cast<unsigned int>(__builtin_clz(s));
-}
-
-#endif
-
-SACO_ALWAYS_INLINE unsigned bsr_de_bruijn_32(unsigned v) {
-	v |= v >> 1;
-	v |= v >> 2;
-	v |= v >> 4;
-	v |= v >> 8;
-	v |= v >> 16;
-
-	static constexpr std::uint_fast8_t TABLE[32] = {0, 9,  1,  10, 13, 21, 2,  29, 11, 14, 16, 18, 22, 25, 3, 30,
-													8, 12, 20, 28, 15, 17, 24, 7,  19, 27, 23, 6,  26, 5,  4, 31};
-
-	return TABLE[static_cast<std::uint32_t>(v * 0x07C4ACDDu) >> 27];
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-struct size_dispatcher_switch {
-	static constexpr std::size_t MAX_SIZE = 2048;
-
-	static std::size_t compute_bucket(std::size_t s) {
-		s = (s < 32) ? 31 : s - 1;
-#if defined(SACO_HAVE_BSR_INTRIN)
-		std::size_t const w = bsr_intrin(static_cast<unsigned>(s));
-		SACO_ASSERT(w == bsr_de_bruijn_32(static_cast<unsigned>(s)));
-#else
-		std::size_t const w = bsr_de_bruijn_32(static_cast<unsigned>(s));
-#endif
-		std::size_t const a = w - 4;
-		std::size_t const b = (s >> (w - 2)) & 3;
-		return (a << 2 | b) - 3;
-	}
-
-	template <template <std::size_t> class Fn>
-	static auto dispatch(std::size_t s) {
-		SACO_ASSERT(s > 0);
-		SACO_ASSERT(s <= MAX_SIZE);
-		auto const bucket = compute_bucket(s);
-
-		switch (bucket) {
-		case 0: return Fn<32>{}();
-		case 1: return Fn<40>{}();
-		case 2: return Fn<48>{}();
-		case 3: return Fn<56>{}();
-		case 4: return Fn<64>{}();
-		case 5: return Fn<80>{}();
-		case 6: return Fn<96>{}();
-		case 7: return Fn<112>{}();
-		case 8: return Fn<128>{}();
-		case 9: return Fn<160>{}();
-		case 10: return Fn<192>{}();
-		case 11: return Fn<224>{}();
-		case 12: return Fn<256>{}();
-		case 13: return Fn<320>{}();
-		case 14: return Fn<384>{}();
-		case 15: return Fn<448>{}();
-		case 16: return Fn<512>{}();
-		case 17: return Fn<640>{}();
-		case 18: return Fn<768>{}();
-		case 19: return Fn<896>{}();
-		case 20: return Fn<1024>{}();
-		case 21: return Fn<1280>{}();
-		case 22: return Fn<1536>{}();
-		case 23: return Fn<1792>{}();
-		case 24: return Fn<2048>{}();
-		default: SACO_ASSERT_MSG(0, "internal error in size dispatcher"); std::abort();
-		}
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-struct size_dispatcher_nested_if {
-	// clang-format off
-	static constexpr std::size_t SIZE_BUCKETS[] = {
-		32,
-		40,
-		48,
-		56,
-		64,
-		80,
-		96,
-		112,
-		128,
-		160,
-		192,
-		224,
-		256,
-		320,
-		384,
-		448,
-		512,
-		640,
-		768,
-		896,
-		1024,
-		1280,
-		1536,
-		1792,
-		//2048,
-	};
-	// clang-format on
-
-	static constexpr int BUCKET_COUNT = sizeof(SIZE_BUCKETS) / sizeof(SIZE_BUCKETS[0]);
-	static constexpr std::size_t MAX_SIZE = SIZE_BUCKETS[BUCKET_COUNT - 1];
-
-	template <template <std::size_t> class Fn, int FIRST, int LAST, int MIDDLE = (FIRST + LAST + 1) / 2>
-	struct impl {
-		static auto step(std::size_t s) {
-			static_assert(FIRST < LAST);
-			static_assert(FIRST < MIDDLE);
-			static_assert(MIDDLE <= LAST);
-			if (s <= SIZE_BUCKETS[MIDDLE - 1])
-				return impl<Fn, FIRST, MIDDLE - 1>::step(s);
-			else
-				return impl<Fn, MIDDLE, LAST>::step(s);
-		}
-	};
-
-	template <template <std::size_t> class Fn, int FIRST>
-	struct impl<Fn, FIRST, FIRST, FIRST> {
-		static auto step(std::size_t s) {
-			return Fn<SIZE_BUCKETS[FIRST]>{}();
-		}
-	};
-
-	template <template <std::size_t> class Fn>
-	static auto dispatch(std::size_t s) {
-		SACO_ASSERT(s > 0);
-		SACO_ASSERT(s <= MAX_SIZE);
-		return impl<Fn, 0, BUCKET_COUNT - 1, 16>::step(s);
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace saco::detail
+#pragma once
+
+#include <saco/xcore.h>
+#include <saco/xutility.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Dispatcher build_shared uses for the sizes up to its MAX_SIZE (see shared_alloc_impl), define SACO_SIZE_DISPATCHER
+// as one of these to override the default (e.g. with the CMake option of the same name).
+#define SACO_SIZE_DISPATCHER_NESTED_IF 1
+#define SACO_SIZE_DISPATCHER_SWITCH 2
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+
+#define SACO_HAVE_BSR_INTRIN
+SACO_ALWAYS_INLINE unsigned bsr_intrin(unsigned s) {
+	unsigned long index;
+	_BitScanReverse(&index, s);
+	return static_cast<unsigned>(index);
+}
+
+#elif defined(__GNUC__) || defined(__clang__)
+
+#define SACO_HAVE_BSR_INTRIN
+SACO_ALWAYS_INLINE unsigned bsr_intrin(unsigned s) {
+	return 31u - static_cast<unsigned int>(__builtin_clz(s));
+}
+
+#endif
+
+// The switch computes the bucket with a bit scan and jumps straight to it, while the nested-if tree takes about
+// log2(buckets) branches, which the CPU mispredicts whenever consecutive sizes differ (see bench/bench_dispatcher.cpp).
+// Without a bit scan instruction, the de Bruijn fallback costs more than walking the tree.
+#if !defined(SACO_SIZE_DISPATCHER)
+#if defined(SACO_HAVE_BSR_INTRIN)
+#define SACO_SIZE_DISPATCHER SACO_SIZE_DISPATCHER_SWITCH
+#else
+#define SACO_SIZE_DISPATCHER SACO_SIZE_DISPATCHER_NESTED_IF
+#endif
+#endif
+
+SACO_ALWAYS_INLINE unsigned bsr_de_bruijn_32(unsigned v) {
+	v |= v >> 1;
+	v |= v >> 2;
+	v |= v >> 4;
+	v |= v >> 8;
+	v |= v >> 16;
+
+	static constexpr std::uint_fast8_t TABLE[32] = {0, 9,  1,  10, 13, 21, 2,  29, 11, 14, 16, 18, 22, 25, 3, 30,
+													8, 12, 20, 28, 15, 17, 24, 7,  19, 27, 23, 6,  26, 5,  4, 31};
+
+	return TABLE[static_cast<std::uint32_t>(v * 0x07C4ACDDu) >> 27];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct size_dispatcher_switch {
+	static constexpr std::size_t MAX_SIZE = 2048;
+
+	static std::size_t compute_bucket(std::size_t s) {
+		s = (s < 32) ? 31 : s - 1;
+#if defined(SACO_HAVE_BSR_INTRIN)
+		std::size_t const w = bsr_intrin(static_cast<unsigned>(s));
+		SACO_ASSERT(w == bsr_de_bruijn_32(static_cast<unsigned>(s)));
+#else
+		std::size_t const w = bsr_de_bruijn_32(static_cast<unsigned>(s));
+#endif
+		std::size_t const a = w - 4;
+		std::size_t const b = (s >> (w - 2)) & 3;
+		return (a << 2 | b) - 3;
+	}
+
+	template <template <std::size_t> class Fn, class... Args>
+	static auto dispatch(std::size_t s, Args&&... args) {
+		SACO_ASSERT(s > 0);
+		SACO_ASSERT(s <= MAX_SIZE);
+		auto const bucket = compute_bucket(s);
+
+		switch (bucket) {
+		case 0: return Fn<32>{}(std::forward<Args>(args)...);
+		case 1: return Fn<40>{}(std::forward<Args>(args)...);
+		case 2: return Fn<48>{}(std::forward<Args>(args)...);
+		case 3: return Fn<56>{}(std::forward<Args>(args)...);
+		case 4: return Fn<64>{}(std::forward<Args>(args)...);
+		case 5: return Fn<80>{}(std::forward<Args>(args)...);
+		case 6: return Fn<96>{}(std::forward<Args>(args)...);
+		case 7: return Fn<112>{}(std::forward<Args>(args)...);
+		case 8: return Fn<128>{}(std::forward<Args>(args)...);
+		case 9: return Fn<160>{}(std::forward<Args>(args)...);
+		case 10: return Fn<192>{}(std::forward<Args>(args)...);
+		case 11: return Fn<224>{}(std::forward<Args>(args)...);
+		case 12: return Fn<256>{}(std::forward<Args>(args)...);
+		case 13: return Fn<320>{}(std::forward<Args>(args)...);
+		case 14: return Fn<384>{}(std::forward<Args>(args)...);
+		case 15: return Fn<448>{}(std::forward<Args>(args)...);
+		case 16: return Fn<512>{}(std::forward<Args>(args)...);
+		case 17: return Fn<640>{}(std::forward<Args>(args)...);
+		case 18: return Fn<768>{}(std::forward<Args>(args)...);
+		case 19: return Fn<896>{}(std::forward<Args>(args)...);
+		case 20: return Fn<1024>{}(std::forward<Args>(args)...);
+		case 21: return Fn<1280>{}(std::forward<Args>(args)...);
+		case 22: return Fn<1536>{}(std::forward<Args>(args)...);
+		case 23: return Fn<1792>{}(std::forward<Args>(args)...);
+		case 24: return Fn<2048>{}(std::forward<Args>(args)...);
+		default: SACO_ASSERT_MSG(0, "internal error in size dispatcher"); std::abort();
+		}
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct size_dispatcher_nested_if {
+	// clang-format off
+	static constexpr std::size_t SIZE_BUCKETS[] = {
+		32,
+		40,
+		48,
+		56,
+		64,
+		80,
+		96,
+		112,
+		128,
+		160,
+		192,
+		224,
+		256,
+		320,
+		384,
+		448,
+		512,
+		640,
+		768,
+		896,
+		1024,
+		1280,
+		1536,
+		1792,
+		//2048,
+	};
+	// clang-format on
+
+	static constexpr int BUCKET_COUNT = sizeof(SIZE_BUCKETS) / sizeof(SIZE_BUCKETS[0]);
+	static constexpr std::size_t MAX_SIZE = SIZE_BUCKETS[BUCKET_COUNT - 1];
+
+	template <template <std::size_t> class Fn, int FIRST, int LAST, int MIDDLE = (FIRST + LAST + 1) / 2>
+	struct impl {
+		template <class... Args>
+		static auto step(std::size_t s, Args&&... args) {
+			static_assert(FIRST < LAST);
+			static_assert(FIRST < MIDDLE);
+			static_assert(MIDDLE <= LAST);
+			if (s <= SIZE_BUCKETS[MIDDLE - 1])
+				return impl<Fn, FIRST, MIDDLE - 1>::step(s, std::forward<Args>(args)...);
+			else
+				return impl<Fn, MIDDLE, LAST>::step(s, std::forward<Args>(args)...);
+		}
+	};
+
+	template <template <std::size_t> class Fn, int FIRST>
+	struct impl<Fn, FIRST, FIRST, FIRST> {
+		template <class... Args>
+		static auto step(std::size_t, Args&&... args) {
+			return Fn<SIZE_BUCKETS[FIRST]>{}(std::forward<Args>(args)...);
+		}
+	};
+
+	template <template <std::size_t> class Fn, class... Args>
+	static auto dispatch(std::size_t s, Args&&... args) {
+		SACO_ASSERT(s > 0);
+		SACO_ASSERT(s <= MAX_SIZE);
+		return impl<Fn, 0, BUCKET_COUNT - 1, 16>::step(s, std::forward<Args>(args)...);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Same bucket scheme as size_dispatcher_switch (four geometric steps per power of two, starting at 32), but extends
+// up to MAX_SIZE. The buckets and the jump table are generated at compile time.
+template <std::size_t MAX_SIZE_>
+struct size_dispatcher_geometric {
+	static_assert(is_power_of_two(MAX_SIZE_));
+	static_assert(MAX_SIZE_ >= 64);
+	static_assert(MAX_SIZE_ <= (std::size_t{1} << 31));
+
+	static constexpr std::size_t MAX_SIZE = MAX_SIZE_;
+
+	static constexpr std::size_t bucket_size(std::size_t bucket) {
+		return (4 + bucket % 4) << (bucket / 4 + 3);
+	}
+
+	static constexpr std::size_t compute_bucket_count() {
+		std::size_t bucket = 0;
+		while (bucket_size(bucket) < MAX_SIZE)
+			bucket++;
+		return bucket + 1;
+	}
+
+	static constexpr std::size_t BUCKET_COUNT = compute_bucket_count();
+
+	static std::size_t compute_bucket(std::size_t s) {
+		return size_dispatcher_switch::compute_bucket(s);
+	}
+
+	template <template <std::size_t> class Fn, class... Args>
+	static auto dispatch(std::size_t s, Args&&... args) {
+		SACO_ASSERT(s > 0);
+		SACO_ASSERT(s <= MAX_SIZE);
+		auto const bucket = compute_bucket(s);
+		SACO_ASSERT(bucket < BUCKET_COUNT);
+		return table<Fn, Args...>::ENTRIES[bucket](std::forward<Args>(args)...);
+	}
+
+private:
+	template <template <std::size_t> class Fn, class... Args>
+	struct table {
+		using result_type = decltype(Fn<32>{}(std::declval<Args>()...));
+		using entry_type = result_type (*)(Args&&...);
+
+		template <std::size_t BUCKET>
+		static result_type entry(Args&&... args) {
+			return Fn<bucket_size(BUCKET)>{}(std::forward<Args>(args)...);
+		}
+
+		template <std::size_t... BUCKETS>
+		static constexpr auto make_entries(std::index_sequence<BUCKETS...>) {
+			return std::array<entry_type, sizeof...(BUCKETS)>{&entry<BUCKETS>...};
+		}
+
+		static constexpr std::array<entry_type, BUCKET_COUNT> ENTRIES =
+				make_entries(std::make_index_sequence<BUCKET_COUNT>{});
+	};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
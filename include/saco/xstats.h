@@ -0,0 +1,90 @@
+#pragma once
+
+#include <saco/xcore.h>
+
+#include <atomic>
+#include <cstddef>
+
+#if defined(__cpp_rtti) || defined(_CPPRTTI)
+#define SACO_HAS_RTTI
+#include <typeinfo>
+#endif
+
+// Define SACO_STATS (in all translation units, e.g. with the CMake option of the same name) to make the build functions
+// record per-type statistics, see saco/stats.h. Without it, the recording functions are empty.
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(SACO_STATS)
+inline constexpr bool STATS_ENABLED = true;
+#else
+inline constexpr bool STATS_ENABLED = false;
+#endif
+
+
+// Counters of one root type. They are registered in a global list on first use and never unregistered.
+struct type_stats {
+	explicit type_stats(char const* type_name) : type_name{type_name} {
+	}
+
+	char const* const type_name;
+	std::atomic<std::size_t> builds{0};
+	std::atomic<std::size_t> block_bytes{0};
+	std::atomic<std::size_t> padding_bytes{0};
+	std::atomic<std::size_t> allocated_bytes{0};
+	type_stats* next{nullptr};
+};
+
+inline std::atomic<type_stats*> g_type_stats_head{nullptr};
+
+inline bool register_type_stats(type_stats* stats) {
+	type_stats* head = g_type_stats_head.load(std::memory_order_relaxed);
+	do
+		stats->next = head;
+	while (!g_type_stats_head.compare_exchange_weak(head, stats, std::memory_order_release, std::memory_order_relaxed));
+	return true;
+}
+
+// Implementation defined name of T. Without RTTI (e.g. -fno-rtti), this is the signature of this function, which
+// names T as well.
+template <class T>
+char const* type_name() {
+#if defined(SACO_HAS_RTTI)
+	return typeid(T).name();
+#elif defined(_MSC_VER)
+	return __FUNCSIG__;
+#else
+	return __PRETTY_FUNCTION__;
+#endif
+}
+
+template <class T>
+type_stats& type_stats_of() {
+	static type_stats stats{type_name<T>()};
+	[[maybe_unused]] static bool const registered = register_type_stats(&stats);
+	return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Records one build of T into a block of `block_size` bytes, which contains `padding` bytes of alignment padding and
+// was carved from an allocation of `allocated_size` bytes (larger than the block when rounded up to a size class).
+template <class T>
+SACO_ALWAYS_INLINE void record_build(
+		[[maybe_unused]] std::size_t block_size,
+		[[maybe_unused]] std::size_t padding,
+		[[maybe_unused]] std::size_t allocated_size) {
+#if defined(SACO_STATS)
+	type_stats& stats = type_stats_of<T>();
+	stats.builds.fetch_add(1, std::memory_order_relaxed);
+	stats.block_bytes.fetch_add(block_size, std::memory_order_relaxed);
+	stats.padding_bytes.fetch_add(padding, std::memory_order_relaxed);
+	stats.allocated_bytes.fetch_add(allocated_size, std::memory_order_relaxed);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <saco/xcore.h>
+#include <saco/xsize_dispatcher.h>
+#include <saco/xutility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#if !defined(SACO_THREAD_CACHE_BYTES_PER_BUCKET)
+#define SACO_THREAD_CACHE_BYTES_PER_BUCKET 16384
+#endif
+
+// Define SACO_SHARED_THREAD_CACHE as 1 to have build_shared take the storage of objects of up to
+// thread_cache::MAX_SIZE bytes from the thread cache. This is off by default: the blocks are rounded up to the cache
+// buckets on top of the size classes of build_shared (e.g. 316 bytes end up in a 384 byte block instead of 352), and
+// the slack as well as the bytes held by the cache are not accounted for by the build statistics.
+#if !defined(SACO_SHARED_THREAD_CACHE)
+#define SACO_SHARED_THREAD_CACHE 0
+#endif
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Per-thread cache of recently freed blocks, keyed by the size buckets of size_dispatcher_switch.
+//
+// Blocks are handed out rounded up to their bucket size, so any block in a bucket's free list can serve any request
+// that maps to the bucket. Each bucket keeps at most SACO_THREAD_CACHE_BYTES_PER_BUCKET bytes, everything beyond that
+// (and everything larger than the largest bucket) goes straight to the global allocator.
+// Blocks freed on a different thread than they were allocated on simply end up in the freeing thread's cache.
+struct thread_cache {
+	using buckets = size_dispatcher_geometric<size_dispatcher_switch::MAX_SIZE>;
+	static constexpr std::size_t MAX_SIZE = buckets::MAX_SIZE;
+	static constexpr std::size_t BUCKET_COUNT = buckets::BUCKET_COUNT;
+
+	struct free_block {
+		free_block* next;
+	};
+
+	// Trivially destructible, so the state stays accessible even after the flusher below ran (e.g. when some other
+	// thread_local object releases a block during thread exit). Such late frees bypass the cache.
+	struct state {
+		free_block* heads[BUCKET_COUNT];
+		std::uint32_t counts[BUCKET_COUNT];
+		bool flusher_registered;
+		bool disabled;
+	};
+
+	struct flusher {
+		~flusher() {
+			state& s = tls_state;
+			for (std::size_t b = 0; b < BUCKET_COUNT; b++) {
+				for (free_block* f = s.heads[b]; f;)
+					free_raw(std::exchange(f, f->next));
+				s.heads[b] = nullptr;
+				s.counts[b] = 0;
+			}
+			s.disabled = true;
+		}
+	};
+
+	static inline thread_local state tls_state{};
+	static inline thread_local flusher tls_flusher;
+
+	static constexpr std::uint32_t max_count(std::size_t bucket) {
+		std::size_t const count = SACO_THREAD_CACHE_BYTES_PER_BUCKET / buckets::bucket_size(bucket);
+		return static_cast<std::uint32_t>(count > 0 ? count : 1);
+	}
+
+	static void* allocate(std::size_t size) {
+		if (SACO_UNLIKELY(size > MAX_SIZE))
+			return alloc_raw(size);
+
+		std::size_t const bucket = buckets::compute_bucket(size);
+		state& s = tls_state;
+		if (free_block* const f = s.heads[bucket]) {
+			s.heads[bucket] = f->next;
+			s.counts[bucket]--;
+			return f;
+		}
+		return alloc_raw(buckets::bucket_size(bucket));
+	}
+
+	static void deallocate(void* p, std::size_t size) {
+		if (SACO_UNLIKELY(size > MAX_SIZE))
+			return free_raw(p);
+
+		std::size_t const bucket = buckets::compute_bucket(size);
+		state& s = tls_state;
+		if (SACO_UNLIKELY(s.counts[bucket] >= max_count(bucket) || !s.flusher_registered))
+			return deallocate_slow(p, bucket);
+		s.heads[bucket] = ::new (p) free_block{s.heads[bucket]};
+		s.counts[bucket]++;
+	}
+
+	static SACO_NOINLINE void deallocate_slow(void* p, std::size_t bucket) {
+		state& s = tls_state;
+		if (!s.flusher_registered && !s.disabled) {
+			// odr-using the flusher makes sure its destructor runs when the thread exits
+			[[maybe_unused]] flusher volatile* const f = &tls_flusher;
+			s.flusher_registered = true;
+		}
+
+		if (s.disabled || s.counts[bucket] >= max_count(bucket))
+			return free_raw(p);
+
+		s.heads[bucket] = ::new (p) free_block{s.heads[bucket]};
+		s.counts[bucket]++;
+	}
+
+	static std::size_t cached_blocks() {
+		std::size_t total = 0;
+		for (std::size_t b = 0; b < BUCKET_COUNT; b++)
+			total += tls_state.counts[b];
+		return total;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Stateless allocator that recycles blocks through the calling thread's cache.
+// Types that need more than the default new alignment bypass the cache.
+template <class T>
+struct thread_cache_allocator {
+	using value_type = T;
+
+	thread_cache_allocator() = default;
+
+	template <class U>
+	thread_cache_allocator(thread_cache_allocator<U> const&) {
+	}
+
+	T* allocate(std::size_t n) {
+		if SACO_IF_CONSTEXPR (alignof(T) > MAX_NEW_ALIGNMENT)
+			return static_cast<T*>(alloc_raw<alignof(T)>(n * sizeof(T)));
+		else
+			return static_cast<T*>(thread_cache::allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) {
+		if SACO_IF_CONSTEXPR (alignof(T) > MAX_NEW_ALIGNMENT)
+			free_raw<alignof(T)>(p);
+		else
+			thread_cache::deallocate(p, n * sizeof(T));
+	}
+
+	template <class U>
+	bool operator==(thread_cache_allocator<U> const&) const {
+		return true;
+	}
+
+	template <class U>
+	bool operator!=(thread_cache_allocator<U> const&) const {
+		return false;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
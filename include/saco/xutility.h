@@ -1,70 +1,136 @@
-#pragma once
-
-#include <saco/xcore.h>
-
-#include <type_traits>
-
-#define SACO_REQUIRES(...) std::enable_if_t<(__VA_ARGS__), int> = 0
-#define SACO_REQUIRES_NON_ARRAY(...) SACO_REQUIRES(!::std::is_array_v<__VA_ARGS__>)
-#define SACO_REQUIRES_UB_ARRAY(...) SACO_REQUIRES(::saco::detail::is_unbounded_array_v<__VA_ARGS__>)
-
-namespace saco::detail {
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T>
-struct is_unbounded_array : std::false_type {};
-
-template <class T>
-struct is_unbounded_array<T[]> : std::true_type {};
-
-template <class T>
-inline constexpr bool is_unbounded_array_v = is_unbounded_array<T>::value;
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-SACO_ALWAYS_INLINE void* alloc_raw(std::size_t size) {
-	auto const p = ::operator new(size);
-
-#if !defined(NDEBUG)
-	if (size >= MAX_NEW_ALIGNMENT) {
-		SACO_ASSERT(reinterpret_cast<std::uintptr_t>(p) % MAX_NEW_ALIGNMENT == 0);
-	} else {
-		std::size_t bits = 0;
-		for (std::size_t s = 2; s <= size; s *= 2)
-			bits++;
-		auto const addr = reinterpret_cast<std::uintptr_t>(p);
-		SACO_ASSERT((addr >> bits << bits) == addr);
-	}
-#endif
-
-	return p;
-}
-
-SACO_ALWAYS_INLINE void free_raw(void* mem) {
-	::operator delete(mem);
-}
-
-struct raw_delete {
-	void operator()(void* p) const {
-		free_raw(p);
-	}
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T>
-void call_dtor(void* p) {
-	static_cast<T*>(p)->~T();
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class T>
-inline constexpr bool is_power_of_two(T value) {
-	return value != 0 && (value & (value - 1)) == 0;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace saco::detail
+#pragma once
+
+#include <saco/xcore.h>
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#define SACO_REQUIRES(...) std::enable_if_t<(__VA_ARGS__), int> = 0
+#define SACO_REQUIRES_NON_ARRAY(...) SACO_REQUIRES(!::std::is_array_v<__VA_ARGS__>)
+#define SACO_REQUIRES_UB_ARRAY(...) SACO_REQUIRES(::saco::detail::is_unbounded_array_v<__VA_ARGS__>)
+#define SACO_REQUIRES_BOUNDED_ARRAY(...) SACO_REQUIRES(::saco::detail::is_bounded_array_v<__VA_ARGS__>)
+
+namespace saco::detail {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+struct is_unbounded_array : std::false_type {};
+
+template <class T>
+struct is_unbounded_array<T[]> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_unbounded_array_v = is_unbounded_array<T>::value;
+
+template <class T>
+struct is_bounded_array : std::false_type {};
+
+template <class T, std::size_t N>
+struct is_bounded_array<T[N]> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_bounded_array_v = is_bounded_array<T>::value;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SACO_ALWAYS_INLINE void* alloc_raw(std::size_t size) {
+	auto const p = ::operator new(size);
+
+#if !defined(NDEBUG)
+	if (size >= MAX_NEW_ALIGNMENT) {
+		SACO_ASSERT(reinterpret_cast<std::uintptr_t>(p) % MAX_NEW_ALIGNMENT == 0);
+	} else {
+		std::size_t bits = 0;
+		for (std::size_t s = 2; s <= size; s *= 2)
+			bits++;
+		auto const addr = reinterpret_cast<std::uintptr_t>(p);
+		SACO_ASSERT((addr >> bits << bits) == addr);
+	}
+#endif
+
+	return p;
+}
+
+SACO_ALWAYS_INLINE void free_raw(void* mem) {
+	::operator delete(mem);
+}
+
+struct raw_delete {
+	void operator()(void* p) const {
+		free_raw(p);
+	}
+};
+
+// Variants for blocks whose first object requires more than the default new alignment.
+template <std::size_t ALIGN>
+SACO_ALWAYS_INLINE void* alloc_raw(std::size_t size) {
+	if SACO_IF_CONSTEXPR (ALIGN <= MAX_NEW_ALIGNMENT)
+		return alloc_raw(size);
+	else
+		return ::operator new(size, std::align_val_t{ALIGN});
+}
+
+template <std::size_t ALIGN>
+SACO_ALWAYS_INLINE void free_raw(void* mem) {
+	if SACO_IF_CONSTEXPR (ALIGN <= MAX_NEW_ALIGNMENT)
+		free_raw(mem);
+	else
+		::operator delete(mem, std::align_val_t{ALIGN});
+}
+
+template <std::size_t ALIGN>
+struct aligned_raw_delete {
+	void operator()(void* p) const {
+		free_raw<ALIGN>(p);
+	}
+};
+
+template <class T>
+inline constexpr std::size_t root_alignment_v = alignof(T) > MAX_NEW_ALIGNMENT ? alignof(T) : MAX_NEW_ALIGNMENT;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define SACO_HAS_EXCEPTIONS
+#endif
+
+// Without exceptions (e.g. -fno-exceptions), these errors are fatal.
+
+[[noreturn]] inline SACO_NOINLINE void throw_size_bound_exceeded() {
+#if defined(SACO_HAS_EXCEPTIONS)
+	throw std::length_error("saco: object does not fit into the given size bound");
+#else
+	SACO_ASSERT_MSG(false, "saco: object does not fit into the given size bound");
+	std::abort();
+#endif
+}
+
+[[noreturn]] inline SACO_NOINLINE void throw_offset_out_of_range() {
+#if defined(SACO_HAS_EXCEPTIONS)
+	throw std::out_of_range("saco: offset_ptr target is out of range for the offset type");
+#else
+	SACO_ASSERT_MSG(false, "saco: offset_ptr target is out of range for the offset type");
+	std::abort();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void call_dtor(void* p) {
+	static_cast<T*>(p)->~T();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline constexpr bool is_power_of_two(T value) {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace saco::detail
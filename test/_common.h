@@ -1,10 +1,12 @@
-#pragma once
-
-#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
-#define DOCTEST_CONFIG_USE_STD_HEADERS
-#define DOCTEST_CONFIG_NO_COMPARISON_WARNING_SUPPRESSION
-
-#define SACO_ASSERT REQUIRE
-#define SACO_ASSERT_MSG REQUIRE_MESSAGE
-
-#include <doctest.h>
+#pragma once
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_USE_STD_HEADERS
+#define DOCTEST_CONFIG_NO_COMPARISON_WARNING_SUPPRESSION
+// doctest 2.4.3 uses SIGSTKSZ as a constant expression, which it no longer is with glibc >= 2.34
+#define DOCTEST_CONFIG_NO_POSIX_SIGNALS
+
+#define SACO_ASSERT REQUIRE
+#define SACO_ASSERT_MSG REQUIRE_MESSAGE
+
+#include <doctest.h>
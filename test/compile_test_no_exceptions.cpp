@@ -0,0 +1,10 @@
+// make sure the core headers can be used without exceptions (e.g. -fno-exceptions)
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/string.h>
+
+int main() {
+	auto const u = saco::build_unique_bounded<int>(64, 1);
+	auto const s = saco::build_shared_bounded<int>(64, 2);
+	return *u + *s == 3 ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+// make sure the headers, including the statistics, can be used without RTTI (e.g. -fno-rtti)
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/stats.h>
+
+int main() {
+	auto const u = saco::build_unique<int>(1);
+	auto const s = saco::build_shared<int>(2);
+	return *u + *s == 3 && saco::stats<int>().builds == 2 ? 0 : 1;
+}
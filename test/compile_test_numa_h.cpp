@@ -0,0 +1,6 @@
+// make sure including our header before anything else works
+#include <saco/numa.h>
+
+int main() {
+	// avoid empty object file warning
+}
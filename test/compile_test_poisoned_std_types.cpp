@@ -1,9 +1,26 @@
-#include "_poison_std_types_in_global_namespace.h"
-
-// make sure our headers don't reference standard types like std::size_t in the global namespace
-#include <saco/saco.h>
-#include <saco/shared_ptr.h>
-
-int main() {
-	// avoid empty object file warning
-}
+#include "_poison_std_types_in_global_namespace.h"
+
+// make sure our headers don't reference standard types like std::size_t in the global namespace
+#include <saco/allocator.h>
+#include <saco/arena.h>
+#include <saco/batch.h>
+#include <saco/layout.h>
+#if !defined(_WIN32)
+#include <saco/huge_page.h>
+#include <saco/image.h>
+#include <saco/shm.h>
+#endif
+#if defined(__linux__)
+#include <saco/numa.h>
+#endif
+#include <saco/offset_ptr.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/shared_ref.h>
+#include <saco/stats.h>
+#include <saco/string.h>
+#include <saco/thread_cache.h>
+
+int main() {
+	// avoid empty object file warning
+}
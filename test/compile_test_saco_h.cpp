@@ -1,6 +1,6 @@
-// make sure including our header before anything else works
-#include <saco/saco.h>
-
-int main() {
-	// avoid empty object file warning
-}
+// make sure including our header before anything else works
+#include <saco/saco.h>
+
+int main() {
+	// avoid empty object file warning
+}
@@ -1,6 +1,6 @@
-// make sure including our header before anything else works
-#include <saco/shared_ptr.h>
-
-int main() {
-	// avoid empty object file warning
-}
+// make sure including our header before anything else works
+#include <saco/shared_ptr.h>
+
+int main() {
+	// avoid empty object file warning
+}
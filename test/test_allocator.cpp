@@ -0,0 +1,234 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/allocator.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct node {
+	static thread_local int tls_instance_count;
+
+	node(int* values, std::size_t count) : values{values}, count{count} {
+		tls_instance_count++;
+	}
+
+	~node() {
+		tls_instance_count--;
+	}
+
+	int* values;
+	std::size_t count;
+};
+
+thread_local int node::tls_instance_count{0};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class counting_resource : public std::pmr::memory_resource {
+public:
+	std::size_t allocations = 0;
+	std::size_t deallocations = 0;
+	std::size_t bytes_in_use = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		allocations++;
+		bytes_in_use += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+		deallocations++;
+		bytes_in_use -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+		return this == &other;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+struct counting_allocator {
+	using value_type = T;
+
+	explicit counting_allocator(std::size_t* live) : live{live} {
+	}
+
+	template <class U>
+	counting_allocator(counting_allocator<U> const& other) : live{other.live} {
+	}
+
+	T* allocate(std::size_t n) {
+		++*live;
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) {
+		--*live;
+		std::allocator<T>{}.deallocate(p, n);
+	}
+
+	template <class U>
+	bool operator==(counting_allocator<U> const& other) const {
+		return live == other.live;
+	}
+
+	template <class U>
+	bool operator!=(counting_allocator<U> const& other) const {
+		return live != other.live;
+	}
+
+	std::size_t* live;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<node> {
+	template <class Context>
+	static node* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] int* const values = saco::place_for_overwrite<int[]>(count, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				values[i] = static_cast<int>(i);
+			return ::new (memory) node{values, count};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void check_node(node const& n, std::size_t count) {
+	REQUIRE(n.count == count);
+	for (std::size_t i = 0; i < count; i++)
+		CHECK(n.values[i] == static_cast<int>(i));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("build_unique_with-memory_resource") {
+	counting_resource resource;
+
+	{
+		saco::pmr::unique_ptr<node> const n = saco::build_unique_with<node>(&resource, 10u);
+		CHECK(node::tls_instance_count == 1);
+		CHECK(resource.allocations == 1);
+		CHECK(resource.bytes_in_use >= sizeof(node) + 10 * sizeof(int));
+		CHECK(n.get_deleter().size() == resource.bytes_in_use);
+		CHECK(reinterpret_cast<std::uintptr_t>(n.get()) % saco::detail::MAX_NEW_ALIGNMENT == 0);
+		check_node(*n, 10);
+	}
+
+	CHECK(node::tls_instance_count == 0);
+	CHECK(resource.deallocations == 1);
+	CHECK(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("build_unique_with-monotonic_buffer_resource") {
+	saco::byte buffer[1024];
+	std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+
+	auto const a = saco::build_unique_with<node>(&resource, 3u);
+	auto const b = saco::build_unique_with<node>(&resource, 5u);
+	CHECK(static_cast<void*>(a.get()) >= static_cast<void*>(buffer));
+	CHECK(static_cast<void*>(b.get()) < static_cast<void*>(buffer + sizeof(buffer)));
+	CHECK(reinterpret_cast<std::uintptr_t>(b.get()) % saco::detail::MAX_NEW_ALIGNMENT == 0);
+	check_node(*a, 3);
+	check_node(*b, 5);
+}
+
+TEST_CASE("build_unique_with-allocator") {
+	std::size_t live = 0;
+
+	{
+		auto const n = saco::build_unique_with<node>(counting_allocator<node>{&live}, 7u);
+		CHECK(live == 1);
+		check_node(*n, 7);
+	}
+
+	CHECK(live == 0);
+	CHECK(node::tls_instance_count == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("build_shared_with-memory_resource") {
+	counting_resource resource;
+
+	{
+		std::shared_ptr<node> const n = saco::build_shared_with<node>(&resource, 10u);
+		CHECK(node::tls_instance_count == 1);
+		CHECK(resource.allocations == 1);
+		check_node(*n, 10);
+	}
+
+	CHECK(node::tls_instance_count == 0);
+	CHECK(resource.deallocations == 1);
+	CHECK(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("build_shared_with-large") {
+	for (std::size_t const count : {std::size_t{1000}, std::size_t{16000}, std::size_t{200000}}) {
+		CAPTURE(count);
+		counting_resource resource;
+
+		{
+			auto const n = saco::build_shared_with<node>(&resource, count);
+			CHECK(node::tls_instance_count == 1);
+			CHECK(resource.allocations == 1);
+			CHECK(resource.bytes_in_use < sizeof(node) + count * sizeof(int) * 5 / 4 + 64);
+			check_node(*n, count);
+		}
+
+		CHECK(node::tls_instance_count == 0);
+		CHECK(resource.deallocations == 1);
+		CHECK(resource.bytes_in_use == 0);
+	}
+}
+
+TEST_CASE("build_shared_with-huge") {
+	counting_resource resource;
+	std::size_t const count = saco::detail::shared_alloc_impl::MAX_SIZE;
+
+	{
+		auto const n = saco::build_shared_with<node>(&resource, count);
+		CHECK(node::tls_instance_count == 1);
+		CHECK(resource.allocations >= 1);
+		check_node(*n, count);
+	}
+
+	CHECK(node::tls_instance_count == 0);
+	CHECK(resource.deallocations == resource.allocations);
+	CHECK(resource.bytes_in_use == 0);
+}
+
+TEST_CASE("build_shared_with-allocator") {
+	std::size_t live = 0;
+
+	{
+		auto const n = saco::build_shared_with<node>(counting_allocator<node>{&live}, 7u);
+		CHECK(live == 1);
+		check_node(*n, 7);
+	}
+
+	CHECK(live == 0);
+	CHECK(node::tls_instance_count == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
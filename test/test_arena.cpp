@@ -0,0 +1,117 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/arena.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct tracked {
+	static thread_local std::vector<int> tls_destroyed;
+
+	explicit tracked(int id) : id{id} {
+	}
+
+	~tracked() {
+		tls_destroyed.push_back(id);
+	}
+
+	int id;
+};
+
+thread_local std::vector<int> tracked::tls_destroyed;
+
+struct record {
+	char* name;
+	std::size_t name_length;
+	int id;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<record> {
+	template <class Context>
+	static record* build(void* memory, Context& ctx, std::size_t name_length, int id) {
+		[[maybe_unused]] char* const name = saco::place_for_overwrite<char[]>(name_length, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < name_length; i++)
+				name[i] = static_cast<char>('a' + i % 26);
+			return ::new (memory) record{name, name_length, id};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("arena-trivially_destructible") {
+	saco::arena a{1024};
+	std::vector<record*> records;
+
+	for (int i = 0; i < 100; i++) {
+		record* const r = a.build<record>(static_cast<std::size_t>(i), i);
+		CHECK(reinterpret_cast<std::uintptr_t>(r) % saco::detail::MAX_NEW_ALIGNMENT == 0);
+		records.push_back(r);
+	}
+
+	for (int i = 0; i < 100; i++) {
+		record const& r = *records[static_cast<std::size_t>(i)];
+		CHECK(r.id == i);
+		REQUIRE(r.name_length == static_cast<std::size_t>(i));
+		for (std::size_t j = 0; j < r.name_length; j++)
+			CHECK(r.name[j] == static_cast<char>('a' + j % 26));
+	}
+
+	// 100 records with 0..99 chars easily fit into a handful of blocks
+	CHECK(a.capacity() < 16 * a.block_size());
+
+	a.release();
+	CHECK(a.capacity() == 0);
+}
+
+TEST_CASE("arena-dtors") {
+	tracked::tls_destroyed.clear();
+
+	{
+		saco::arena a;
+		for (int i = 0; i < 3; i++)
+			CHECK(a.build<tracked>(i)->id == i);
+		CHECK(tracked::tls_destroyed.empty());
+	}
+
+	// destroyed in reverse order of construction
+	REQUIRE(tracked::tls_destroyed.size() == 3);
+	CHECK(tracked::tls_destroyed[0] == 2);
+	CHECK(tracked::tls_destroyed[1] == 1);
+	CHECK(tracked::tls_destroyed[2] == 0);
+}
+
+TEST_CASE("arena-large_objects") {
+	saco::arena a{256};
+
+	record* const small1 = a.build<record>(8u, 1);
+	record* const large = a.build<record>(1000u, 2);
+	record* const small2 = a.build<record>(8u, 3);
+
+	CHECK(small1->id == 1);
+	CHECK(large->id == 2);
+	CHECK(large->name[999] == static_cast<char>('a' + 999 % 26));
+	CHECK(small2->id == 3);
+
+	// the large object gets its own block and does not discard the current one
+	CHECK(reinterpret_cast<char*>(small2) - reinterpret_cast<char*>(small1) < 256);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
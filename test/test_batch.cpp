@@ -0,0 +1,128 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/batch.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct event {
+	static thread_local int tls_instance_count;
+
+	event(int id, char const* payload, std::size_t size) : id{id}, payload{payload}, size{size} {
+		tls_instance_count++;
+	}
+
+	~event() {
+		tls_instance_count--;
+	}
+
+	std::string_view view() const {
+		return {payload, size};
+	}
+
+	int id;
+	char const* payload;
+	std::size_t size;
+};
+
+thread_local int event::tls_instance_count{0};
+
+} // namespace
+
+template <>
+struct saco::builder<event> {
+	template <class Context>
+	static event* build(void* memory, Context& ctx, int id, std::string_view payload) {
+		[[maybe_unused]] char* const chars = saco::place_for_overwrite<char[]>(payload.size(), ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			if (id < 0)
+				throw std::runtime_error("bad event");
+			payload.copy(chars, payload.size());
+			return ::new (memory) event{id, chars, payload.size()};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("build_unique_batch") {
+	std::vector<std::tuple<int, std::string_view>> const args{
+			{1, "one"},
+			{2, "two"},
+			{3, "a somewhat longer payload"},
+			{4, ""},
+	};
+
+	{
+		auto objects = saco::build_unique_batch<event>(args);
+		REQUIRE(objects.size() == args.size());
+		CHECK(event::tls_instance_count == 4);
+
+		for (std::size_t i = 0; i < args.size(); i++) {
+			CHECK(objects[i]->id == std::get<0>(args[i]));
+			CHECK(objects[i]->view() == std::get<1>(args[i]));
+		}
+
+		// one block, in order
+		for (std::size_t i = 1; i < objects.size(); i++) {
+			auto const prev = reinterpret_cast<std::uintptr_t>(objects[i - 1].get());
+			auto const next = reinterpret_cast<std::uintptr_t>(objects[i].get());
+			CHECK(next > prev);
+			CHECK(next - prev <= sizeof(event) + 32);
+		}
+
+		// objects can be released in any order, the block stays alive until the last one is gone
+		objects[1].reset();
+		objects[3].reset();
+		CHECK(event::tls_instance_count == 2);
+		CHECK(objects[0]->view() == "one");
+		objects[0].reset();
+		CHECK(objects[2]->view() == "a somewhat longer payload");
+	}
+
+	CHECK(event::tls_instance_count == 0);
+}
+
+TEST_CASE("build_unique_batch-empty") {
+	std::vector<std::tuple<int, std::string_view>> const args;
+	CHECK(saco::build_unique_batch<event>(args).empty());
+}
+
+TEST_CASE("build_unique_batch-exception") {
+	std::vector<std::tuple<int, std::string_view>> const args{{1, "one"}, {2, "two"}, {-1, "bad"}, {4, "four"}};
+	CHECK_THROWS_AS(saco::build_unique_batch<event>(args), std::runtime_error);
+	CHECK(event::tls_instance_count == 0);
+}
+
+TEST_CASE("build_many") {
+	{
+		auto const objects = saco::build_many<event>(100, 7, std::string_view{"same"});
+		REQUIRE(objects.size() == 100);
+		CHECK(event::tls_instance_count == 100);
+		for (auto const& e : objects) {
+			CHECK(e->id == 7);
+			CHECK(e->view() == "same");
+		}
+	}
+
+	CHECK(event::tls_instance_count == 0);
+	CHECK(saco::build_many<event>(0, 7, std::string_view{"none"}).empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
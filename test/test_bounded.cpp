@@ -0,0 +1,130 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct text {
+	static thread_local int tls_measure_count;
+	static thread_local int tls_construct_count;
+
+	char const* data;
+	std::size_t size;
+};
+
+thread_local int text::tls_measure_count{0};
+thread_local int text::tls_construct_count{0};
+
+struct bounded_text : text {};
+
+template <class Context>
+text* build_text(void* memory, Context& ctx, std::string_view sv) {
+	[[maybe_unused]] char* const chars = saco::place_for_overwrite<char[]>(sv.size(), ctx);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		text::tls_construct_count++;
+		sv.copy(chars, sv.size());
+		return ::new (memory) text{chars, sv.size()};
+	} else {
+		text::tls_measure_count++;
+		return nullptr;
+	}
+}
+
+} // namespace
+
+template <>
+struct saco::builder<text> {
+	template <class Context>
+	static text* build(void* memory, Context& ctx, std::string_view sv) {
+		return build_text(memory, ctx, sv);
+	}
+};
+
+template <>
+struct saco::builder<bounded_text> {
+	static std::size_t max_size(std::string_view sv) {
+		return sizeof(bounded_text) + sv.size();
+	}
+
+	template <class Context>
+	static bounded_text* build(void* memory, Context& ctx, std::string_view sv) {
+		return static_cast<bounded_text*>(build_text(memory, ctx, sv));
+	}
+};
+
+static_assert(!saco::detail::has_max_size_v<text, std::string_view>);
+static_assert(saco::detail::has_max_size_v<bounded_text, std::string_view>);
+static_assert(saco::detail::has_max_size_v<bounded_text, std::string_view const&>);
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void reset_counts() {
+	text::tls_measure_count = 0;
+	text::tls_construct_count = 0;
+}
+
+TEST_CASE("build_unique-two_pass") {
+	reset_counts();
+	auto const t = saco::build_unique<text>(std::string_view{"hello"});
+	CHECK(std::string_view(t->data, t->size) == "hello");
+	CHECK(text::tls_measure_count == 1);
+	CHECK(text::tls_construct_count == 1);
+}
+
+TEST_CASE("build_unique_bounded") {
+	reset_counts();
+	auto const t = saco::build_unique_bounded<text>(64, std::string_view{"hello"});
+	CHECK(std::string_view(t->data, t->size) == "hello");
+	CHECK(text::tls_measure_count == 0);
+	CHECK(text::tls_construct_count == 1);
+}
+
+TEST_CASE("build_unique-max_size_hook") {
+	reset_counts();
+	auto const t = saco::build_unique<bounded_text>(std::string_view{"hello"});
+	CHECK(std::string_view(t->data, t->size) == "hello");
+	CHECK(text::tls_measure_count == 0);
+	CHECK(text::tls_construct_count == 1);
+}
+
+TEST_CASE("build_shared-max_size_hook") {
+	reset_counts();
+	auto const t = saco::build_shared<bounded_text>(std::string_view{"hello"});
+	CHECK(std::string_view(t->data, t->size) == "hello");
+	CHECK(text::tls_measure_count == 0);
+	CHECK(text::tls_construct_count == 1);
+}
+
+TEST_CASE("build_shared_bounded-large") {
+	std::string_view const sv{"0123456789"};
+	auto const t = saco::build_shared_bounded<text>(saco::detail::shared_alloc_impl::MAX_SIZE + 1, sv);
+	CHECK(std::string_view(t->data, t->size) == sv);
+}
+
+TEST_CASE("build_unique_bounded-exceeded") {
+	reset_counts();
+	CHECK_THROWS_AS(saco::build_unique_bounded<text>(sizeof(text) + 4, std::string_view{"hello"}), std::length_error);
+	CHECK(text::tls_construct_count == 0);
+	CHECK_THROWS_AS(saco::build_shared_bounded<text>(sizeof(text) + 4, std::string_view{"hello"}), std::length_error);
+	CHECK(text::tls_construct_count == 0);
+	CHECK_THROWS_AS(saco::build_shared_bounded<text>(0, std::string_view{"hello"}), std::length_error);
+	CHECK_THROWS_AS(saco::build_shared_bounded<text>(sizeof(text) - 1, std::string_view{"hello"}), std::length_error);
+	CHECK(text::tls_construct_count == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
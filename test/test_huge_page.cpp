@@ -0,0 +1,92 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/allocator.h>
+#include <saco/huge_page.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct table {
+	std::uint32_t* slots;
+	std::size_t count;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<table> {
+	template <class Context>
+	static table* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] std::uint32_t* const slots = saco::place_for_overwrite<std::uint32_t[]>(count, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				slots[i] = static_cast<std::uint32_t>(i * 7);
+			return ::new (memory) table{slots, count};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::size_t HUGE_PAGE = saco::detail::HUGE_PAGE_SIZE;
+
+void check_table(table const& t, std::size_t count) {
+	REQUIRE(t.count == count);
+	for (std::size_t i = 0; i < count; i++)
+		if (t.slots[i] != i * 7)
+			FAIL_CHECK("slot " << i);
+}
+
+TEST_CASE("build_unique_huge") {
+	for (std::size_t const count : {std::size_t{0}, std::size_t{100}, HUGE_PAGE / 4, HUGE_PAGE, HUGE_PAGE + 3}) {
+		CAPTURE(count);
+		saco::huge_page_unique_ptr<table> const t = saco::build_unique_huge<table>(count);
+		check_table(*t, count);
+
+		// large blocks start at a huge page boundary, small ones come from operator new
+		std::size_t const size = t.get_deleter().size();
+		CHECK(size >= sizeof(table) + count * sizeof(std::uint32_t));
+		if (size >= HUGE_PAGE)
+			CHECK(reinterpret_cast<std::uintptr_t>(t.get()) % HUGE_PAGE == 0);
+	}
+}
+
+TEST_CASE("huge_page_allocator-threshold") {
+	saco::huge_page_allocator<saco::byte> const alloc{0};
+
+	auto const a = saco::build_unique_with<table>(alloc, 10u);
+	auto const b = saco::build_unique_with<table>(alloc, 20u);
+	CHECK(reinterpret_cast<std::uintptr_t>(a.get()) % HUGE_PAGE == 0);
+	CHECK(reinterpret_cast<std::uintptr_t>(b.get()) % HUGE_PAGE == 0);
+	CHECK(a.get_deleter().get_allocator().threshold() == 0);
+	check_table(*a, 10);
+	check_table(*b, 20);
+
+	// rebinding keeps the threshold
+	saco::huge_page_allocator<std::uint64_t> const rebound{alloc};
+	CHECK(rebound == alloc);
+	CHECK(rebound != saco::huge_page_allocator<saco::byte>{});
+}
+
+TEST_CASE("build_shared_with-huge_page_allocator") {
+	for (std::size_t const count : {std::size_t{10}, HUGE_PAGE}) {
+		CAPTURE(count);
+		std::shared_ptr<table> const t = saco::build_shared_with<table>(saco::huge_page_allocator<saco::byte>{}, count);
+		check_table(*t, count);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
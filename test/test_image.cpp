@@ -0,0 +1,145 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/image.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct table {
+	table(std::uint64_t* keys, std::size_t count, char const* name, std::size_t name_size) :
+			keys{keys, count},
+			name{name, name_size} {
+	}
+
+	std::string_view get_name() const {
+		return {name.data(), name.size()};
+	}
+
+	saco::offset_span<std::uint64_t> keys;
+	saco::offset_span<char const> name;
+};
+
+struct other {
+	std::uint64_t value;
+};
+
+} // namespace
+
+template <>
+struct saco::is_relocatable<table> : std::true_type {};
+template <>
+struct saco::is_relocatable<other> : std::true_type {};
+
+template <>
+struct saco::builder<table> {
+	template <class Context>
+	static table* build(void* memory, Context& ctx, std::size_t count, std::string_view name) {
+		[[maybe_unused]] auto const keys = saco::place_for_overwrite<std::uint64_t[]>(count, ctx);
+		[[maybe_unused]] char* const chars = saco::place_for_overwrite<char[]>(name.size(), ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				keys[i] = i * 7919;
+			name.copy(chars, name.size());
+			return ::new (memory) table{keys, count, chars, name.size()};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void check_table(table const& t, std::size_t count, std::string_view name) {
+	REQUIRE(t.keys.size() == count);
+	for (std::size_t i = 0; i < count; i++)
+		CHECK(t.keys[i] == i * 7919);
+	CHECK(t.get_name() == name);
+}
+
+void patch_file(std::string const& path, long offset, unsigned char value) {
+	std::FILE* const f = std::fopen(path.c_str(), "r+b");
+	REQUIRE(f);
+	std::fseek(f, offset, SEEK_SET);
+	std::fputc(value, f);
+	std::fclose(f);
+}
+
+TEST_CASE("image-save-map") {
+	std::string const image_path = "saco_test_image_save-map.bin";
+	{
+		auto const t = saco::build_relocatable<table>(std::size_t{1000}, std::string_view{"primes-ish"});
+		saco::save(t, image_path);
+	}
+
+	saco::mapped_ptr<table> m = saco::map<table>(image_path);
+	REQUIRE(m);
+	check_table(*m, 1000, "primes-ish");
+	CHECK(m.size() >= sizeof(table) + 1000 * sizeof(std::uint64_t));
+
+	saco::mapped_ptr<table> const moved = std::move(m);
+	CHECK(!m);
+	check_table(*moved, 1000, "primes-ish");
+
+	std::remove(image_path.c_str());
+}
+
+TEST_CASE("image-overwrite-while-mapped") {
+	std::string const image_path = "saco_test_image_overwrite-while-mapped.bin";
+	saco::save(saco::build_relocatable<table>(std::size_t{10}, std::string_view{"old"}), image_path);
+	auto const old_image = saco::map<table>(image_path);
+
+	saco::save(saco::build_relocatable<table>(std::size_t{20}, std::string_view{"new"}), image_path);
+	auto const new_image = saco::map<table>(image_path);
+
+	check_table(*old_image, 10, "old");
+	check_table(*new_image, 20, "new");
+
+	std::remove(image_path.c_str());
+}
+
+TEST_CASE("image-invalid") {
+	std::string const image_path = "saco_test_image_invalid.bin";
+	saco::save(saco::build_relocatable<table>(std::size_t{100}, std::string_view{"t"}), image_path);
+
+	CHECK_THROWS_AS(saco::map<other>(image_path), std::runtime_error);
+
+	// corrupt a key
+	long const payload_offset = static_cast<long>(saco::detail::image_payload_offset_v<table>);
+	patch_file(image_path, payload_offset + static_cast<long>(sizeof(table)) + 8, 0xFF);
+	CHECK_THROWS_AS(saco::map<table>(image_path), std::runtime_error);
+	CHECK(saco::map<table>(image_path, false));
+
+	// corrupt the magic
+	patch_file(image_path, 0, 'X');
+	CHECK_THROWS_AS(saco::map<table>(image_path, false), std::runtime_error);
+
+	std::remove(image_path.c_str());
+	CHECK_THROWS_AS(saco::map<table>(image_path), std::system_error);
+}
+
+TEST_CASE("image-truncated") {
+	std::string const image_path = "saco_test_image_truncated.bin";
+	auto const t = saco::build_relocatable<table>(std::size_t{100}, std::string_view{"t"});
+	saco::save(t, image_path);
+	REQUIRE(::truncate(image_path.c_str(), 200) == 0);
+	CHECK_THROWS_AS(saco::map<table>(image_path, false), std::runtime_error);
+	std::remove(image_path.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
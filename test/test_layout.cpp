@@ -0,0 +1,281 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/layout.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/string.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct record {
+	char* tag;
+	double* weights;
+	std::uint16_t* ids;
+	char* name;
+	std::size_t count;
+};
+
+struct sorted_record : record {};
+
+struct item {
+	int value;
+	std::string_view debug_name;
+};
+
+struct hot_cold {
+	int* values;
+	std::size_t count;
+	std::string_view debug_name;
+	std::uint64_t* stats;
+	item* items;
+};
+
+struct counter {
+	std::uint64_t hits;
+	item* last;
+};
+
+struct shared_stats {
+	std::uint32_t config[3];
+	counter* counters;
+	std::size_t thread_count;
+	counter* total;
+	std::uint8_t* tail;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<record> {
+	template <class Context>
+	static record* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] char* const tag = saco::place_for_overwrite<char[]>(3, ctx);
+		[[maybe_unused]] double* const weights = saco::place_for_overwrite<double[]>(count, ctx);
+		[[maybe_unused]] std::uint16_t* const ids = saco::place_for_overwrite<std::uint16_t[]>(count, ctx);
+		[[maybe_unused]] char* const name = saco::place_for_overwrite<char[]>(5, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) record{tag, weights, ids, name, count};
+		else
+			return nullptr;
+	}
+};
+
+template <>
+struct saco::builder<sorted_record> {
+	template <class Context>
+	static sorted_record* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] auto const [tag, weights, ids, name] =
+				saco::place_sorted_for_overwrite<char[], double[], std::uint16_t[], char[]>(ctx, 3, count, count, 5);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) sorted_record{{tag, weights, ids, name, count}};
+		else
+			return nullptr;
+	}
+};
+
+template <>
+struct saco::builder<item> {
+	static constexpr bool uniform_size = true;
+
+	template <class Context>
+	static item* build(void* memory, Context& ctx, std::string_view name) {
+		saco::cold_context<Context> cold{ctx};
+		[[maybe_unused]] auto const debug_name = saco::place_string_view(cold, name);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) item{7, debug_name};
+		else
+			return nullptr;
+	}
+};
+
+template <>
+struct saco::builder<hot_cold> {
+	template <class Context>
+	static hot_cold* build(void* memory, Context& ctx, std::size_t count, std::string_view name) {
+		[[maybe_unused]] std::uint64_t* const stats = saco::place_cold_for_overwrite<std::uint64_t[]>(4, ctx);
+		[[maybe_unused]] int* const values = saco::place_for_overwrite<int[]>(count, ctx);
+		saco::cold_context<Context> cold{ctx};
+		[[maybe_unused]] auto const debug_name = saco::place_string_view(cold, name);
+		[[maybe_unused]] item* const items = saco::place<item[]>(count, ctx, name);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				values[i] = static_cast<int>(i);
+			for (std::size_t i = 0; i < 4; i++)
+				stats[i] = i;
+			return ::new (memory) hot_cold{values, count, debug_name, stats, items};
+		} else
+			return nullptr;
+	}
+};
+
+template <>
+struct saco::builder<counter> {
+	template <class Context>
+	static counter* build(void* memory, Context& ctx) {
+		// sub-objects of isolated objects are placed normally, behind the isolated lines
+		[[maybe_unused]] item* const last = saco::place<item>(ctx, std::string_view{"last"});
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) counter{0, last};
+		else
+			return nullptr;
+	}
+};
+
+template <>
+struct saco::builder<shared_stats> {
+	template <class Context>
+	static shared_stats* build(void* memory, Context& ctx, std::size_t thread_count) {
+		[[maybe_unused]] counter* const counters = saco::place_isolated<counter[]>(thread_count, ctx);
+		[[maybe_unused]] counter* const total = saco::place_isolated_for_overwrite<counter>(ctx);
+		[[maybe_unused]] std::uint8_t* const tail = saco::place_for_overwrite<std::uint8_t[]>(1, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) shared_stats{{1, 2, 3}, counters, thread_count, total, tail};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr auto order = saco::detail::alignment_order<char[], double[], std::uint16_t[], char[]>();
+static_assert(order[0] == 1 && order[1] == 2 && order[2] == 0 && order[3] == 3);
+
+template <class T>
+std::size_t measure(std::size_t count) {
+	saco::measure_context mctx;
+	saco::place<T>(mctx, count);
+	return mctx.required_size();
+}
+
+TEST_CASE("place_sorted_for_overwrite") {
+	for (std::size_t const count : {0, 1, 3, 10}) {
+		CAPTURE(count);
+		std::size_t const payload = 3 + count * (sizeof(double) + sizeof(std::uint16_t)) + 5;
+		std::size_t const sorted_size = measure<sorted_record>(count);
+		CHECK(sorted_size == sizeof(record) + payload);
+		CHECK(sorted_size <= measure<record>(count));
+
+		auto const r = saco::build_unique_bounded<sorted_record>(sorted_size, count);
+		REQUIRE(r->count == count);
+		if (count > 0) {
+			CHECK(reinterpret_cast<std::uintptr_t>(r->weights) % alignof(double) == 0);
+			CHECK(reinterpret_cast<std::uintptr_t>(r->ids) % alignof(std::uint16_t) == 0);
+			CHECK(static_cast<void*>(r->weights) < static_cast<void*>(r->ids));
+			CHECK(static_cast<void*>(r->ids) < static_cast<void*>(r->tag));
+		} else {
+			CHECK(r->weights == nullptr);
+			CHECK(r->ids == nullptr);
+		}
+		CHECK(static_cast<void*>(r->tag) < static_cast<void*>(r->name));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void check_hot_cold(hot_cold const& h, std::size_t count, std::string_view name) {
+	REQUIRE(h.count == count);
+	CHECK(h.debug_name == name);
+	for (std::size_t i = 0; i < count; i++) {
+		CHECK(h.values[i] == static_cast<int>(i));
+		CHECK(h.items[i].value == 7);
+		CHECK(h.items[i].debug_name == name);
+	}
+	for (std::size_t i = 0; i < 4; i++)
+		CHECK(h.stats[i] == i);
+
+	// hot parts first, right behind the root
+	auto const root = reinterpret_cast<std::uintptr_t>(&h);
+	auto const hot_end = count ? reinterpret_cast<std::uintptr_t>(h.items + count) : root + sizeof(hot_cold);
+	if (count)
+		CHECK(reinterpret_cast<std::uintptr_t>(h.values) == root + sizeof(hot_cold));
+	CHECK(hot_end <= reinterpret_cast<std::uintptr_t>(h.stats));
+	if (!name.empty()) {
+		CHECK(hot_end <= reinterpret_cast<std::uintptr_t>(h.debug_name.data()));
+		for (std::size_t i = 0; i < count; i++)
+			CHECK(hot_end <= reinterpret_cast<std::uintptr_t>(h.items[i].debug_name.data()));
+	}
+}
+
+TEST_CASE("place_cold") {
+	for (std::size_t const count : {0, 1, 2, 5, 64})
+		for (std::string_view const name : {"", "x", "a debug name", "sixteen chars!!!"}) {
+			CAPTURE(count);
+			CAPTURE(name);
+
+			saco::measure_context mctx;
+			saco::place<hot_cold>(mctx, count, name);
+			std::size_t const size = mctx.required_size();
+
+			// the measured size is enough, also when constructed into exactly that size
+			check_hot_cold(*saco::build_unique_bounded<hot_cold>(size, count, name), count, name);
+			check_hot_cold(*saco::build_unique<hot_cold>(count, name), count, name);
+			check_hot_cold(*saco::build_shared<hot_cold>(count, name), count, name);
+		}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::uintptr_t LINE = SACO_CACHE_LINE_SIZE;
+
+std::uintptr_t address(void const* p) {
+	return reinterpret_cast<std::uintptr_t>(p);
+}
+
+void check_shared_stats(shared_stats const& s, std::size_t thread_count) {
+	REQUIRE(s.thread_count == thread_count);
+	CHECK(s.config[2] == 3);
+
+	// every isolated part starts on a line of its own and nothing else shares its last line
+	auto const root_end = address(&s) + sizeof(shared_stats);
+	if (thread_count) {
+		CHECK(address(s.counters) % LINE == 0);
+		CHECK(address(s.counters) >= root_end);
+		std::size_t const lines = (thread_count * sizeof(counter) + LINE - 1) / LINE;
+		CHECK(address(s.counters[0].last) == address(s.counters) + lines * LINE);
+		for (std::size_t i = 0; i < thread_count; i++) {
+			CHECK(s.counters[i].hits == 0);
+			CHECK(s.counters[i].last->value == 7);
+			CHECK(address(s.counters[i].last) < address(s.total));
+		}
+	} else
+		CHECK(s.counters == nullptr);
+
+	CHECK(address(s.total) % LINE == 0);
+	CHECK(address(s.total) >= root_end);
+	CHECK(address(s.tail) >= address(s.total) + LINE);
+}
+
+TEST_CASE("place_isolated") {
+	for (std::size_t const thread_count : {0, 1, 3, 4, 5, 16}) {
+		CAPTURE(thread_count);
+
+		saco::measure_context mctx;
+		saco::place<shared_stats>(mctx, thread_count);
+		std::size_t const size = mctx.required_size();
+
+		check_shared_stats(*saco::build_unique_bounded<shared_stats>(size, thread_count), thread_count);
+		check_shared_stats(*saco::build_unique<shared_stats>(thread_count), thread_count);
+		check_shared_stats(*saco::build_shared<shared_stats>(thread_count), thread_count);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,97 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/numa.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct table {
+	std::uint64_t* slots;
+	std::size_t count;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<table> {
+	template <class Context>
+	static table* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] std::uint64_t* const slots = saco::place_for_overwrite<std::uint64_t[]>(count, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				slots[i] = i;
+			return ::new (memory) table{slots, count};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// node of the page holding `p` (get_mempolicy with MPOL_F_NODE | MPOL_F_ADDR), -1 if unknown
+int node_of(void const* p) {
+	int node = -1;
+	if (::syscall(SYS_get_mempolicy, &node, nullptr, 0, p, 3) != 0)
+		return -1;
+	return node;
+}
+
+void check_table(table const& t, std::size_t count) {
+	REQUIRE(t.count == count);
+	for (std::size_t i = 0; i < count; i++)
+		if (t.slots[i] != i)
+			FAIL_CHECK("slot " << i);
+}
+
+TEST_CASE("build_unique_on_node") {
+	for (std::size_t const count : {std::size_t{1}, std::size_t{1000}, std::size_t{1} << 19}) {
+		CAPTURE(count);
+		saco::numa_unique_ptr<table> const t = saco::build_unique_on_node<table>(0, count);
+		check_table(*t, count);
+		CHECK(reinterpret_cast<std::uintptr_t>(t.get()) % 4096 == 0);
+		CHECK(t.get_deleter().get_allocator().node() == 0);
+
+		int const node = node_of(t.get());
+		if (node >= 0) {
+			CHECK(node == 0);
+			CHECK(node_of(t->slots + count - 1) == 0);
+		}
+	}
+}
+
+TEST_CASE("build_unique_on_node-local") {
+	auto const t = saco::build_unique_on_node<table>(saco::LOCAL_NUMA_NODE, 100u);
+	check_table(*t, 100);
+	CHECK(saco::current_numa_node() >= 0);
+}
+
+TEST_CASE("build_unique_on_node-invalid") {
+	CHECK_THROWS_AS(saco::build_unique_on_node<table>(-7, 10u), std::system_error);
+	CHECK_THROWS_AS(saco::build_unique_on_node<table>(saco::detail::MAX_NUMA_NODES, 10u), std::system_error);
+}
+
+TEST_CASE("build_shared_on_node") {
+	for (std::size_t const count : {std::size_t{10}, std::size_t{1} << 19}) {
+		CAPTURE(count);
+		std::shared_ptr<table> const t = saco::build_shared_on_node<table>(0, count);
+		check_table(*t, count);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
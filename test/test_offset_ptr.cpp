@@ -0,0 +1,141 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/offset_ptr.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct child {
+	explicit child(int value) : value{value} {
+	}
+
+	int value;
+};
+
+struct record {
+	record(int* values, std::size_t count, char const* name, std::size_t name_size, child* c) :
+			values{values, count},
+			name{name, name_size},
+			c{c} {
+	}
+
+	std::string_view get_name() const {
+		return {name.data(), name.size()};
+	}
+
+	std::uint32_t id = 42;
+	saco::offset_span<int> values;
+	saco::offset_span<char const, std::int16_t> name;
+	saco::unique_o16_ptr<child> c;
+};
+
+} // namespace
+
+template <>
+struct saco::is_relocatable<record> : std::true_type {};
+
+template <>
+struct saco::builder<record> {
+	template <class Context>
+	static record* build(void* memory, Context& ctx, std::size_t count, std::string_view name) {
+		[[maybe_unused]] int* const values = saco::place_for_overwrite<int[]>(count, ctx);
+		[[maybe_unused]] char* const chars = saco::place_for_overwrite<char[]>(name.size(), ctx);
+		[[maybe_unused]] child* const c = saco::place<child>(ctx, static_cast<int>(count));
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				values[i] = static_cast<int>(i * i);
+			name.copy(chars, name.size());
+			return ::new (memory) record{values, count, chars, name.size(), c};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static_assert(sizeof(saco::o8_ptr<int>) == 1);
+static_assert(sizeof(saco::o16_ptr<int>) == 2);
+static_assert(sizeof(saco::unique_o32_ptr<child>) == 4);
+static_assert(sizeof(saco::offset_span<char, std::int16_t>) == 4);
+
+void check_record(record const& r, std::size_t count, std::string_view name) {
+	CHECK(r.id == 42);
+	REQUIRE(r.values.size() == count);
+	for (std::size_t i = 0; i < count; i++)
+		CHECK(r.values[i] == static_cast<int>(i * i));
+	CHECK(r.get_name() == name);
+	REQUIRE(r.c);
+	CHECK(r.c->value == static_cast<int>(count));
+}
+
+TEST_CASE("build_relocatable") {
+	auto const r = saco::build_relocatable<record>(std::size_t{10}, std::string_view{"ten"});
+	CHECK(r.get_deleter().size() >= sizeof(record) + 10 * sizeof(int) + 3 + sizeof(child));
+	check_record(*r, 10, "ten");
+}
+
+TEST_CASE("relocatable-clone") {
+	auto original = saco::build_relocatable<record>(std::size_t{100}, std::string_view{"hundred"});
+	auto const copy = saco::clone(original);
+	REQUIRE(copy.get() != original.get());
+	CHECK(copy.get_deleter().size() == original.get_deleter().size());
+	CHECK(copy->values.data() != original->values.data());
+
+	original.reset();
+	check_record(*copy, 100, "hundred");
+
+	saco::relocatable_ptr<record> const empty;
+	CHECK(!saco::clone(empty));
+}
+
+TEST_CASE("relocatable-relocate_copy") {
+	alignas(saco::detail::MAX_NEW_ALIGNMENT) saco::byte buffer[1024];
+
+	auto const r = saco::build_relocatable<record>(std::size_t{20}, std::string_view{"twenty"});
+	REQUIRE(r.get_deleter().size() <= sizeof(buffer));
+	record* const copy = saco::relocate_copy(r.get(), r.get_deleter().size(), buffer);
+	r->values[0] = -1;
+	check_record(*copy, 20, "twenty");
+	copy->~record();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("offset_ptr-out-of-range") {
+	struct far {
+		saco::o8_ptr<char> p;
+		char pad[300];
+	};
+
+	far f;
+	CHECK(!f.p);
+	f.p = &f.pad[10];
+	CHECK(f.p.get() == &f.pad[10]);
+	CHECK_THROWS_AS(f.p = &f.pad[299], std::out_of_range);
+	f.p = nullptr;
+	CHECK(!f.p);
+	CHECK(f.p.get() == nullptr);
+}
+
+TEST_CASE("offset_span-size-out-of-range") {
+	char chars[300];
+	CHECK_NOTHROW(saco::offset_span<char, std::int16_t>{chars, sizeof(chars)});
+	CHECK_THROWS_AS((saco::offset_span<char, std::int8_t>{chars, sizeof(chars)}), std::out_of_range);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
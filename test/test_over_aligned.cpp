@@ -0,0 +1,118 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/allocator.h>
+#include <saco/arena.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t ALIGN>
+struct alignas(ALIGN) aligned_head {
+	static thread_local int tls_instance_count;
+
+	aligned_head(double* values, std::size_t count) : values{values}, count{count} {
+		tls_instance_count++;
+	}
+
+	~aligned_head() {
+		tls_instance_count--;
+	}
+
+	double* values;
+	std::size_t count;
+};
+
+template <std::size_t ALIGN>
+thread_local int aligned_head<ALIGN>::tls_instance_count{0};
+
+} // namespace
+
+template <std::size_t ALIGN>
+struct saco::builder<aligned_head<ALIGN>> {
+	template <class Context>
+	static aligned_head<ALIGN>* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] double* const values = saco::place<double[]>(count, ctx, 1.5);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) aligned_head<ALIGN>{values, count};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t ALIGN>
+void check_head(aligned_head<ALIGN> const* h, std::size_t count) {
+	REQUIRE(h != nullptr);
+	CHECK(reinterpret_cast<std::uintptr_t>(h) % ALIGN == 0);
+	REQUIRE(h->count == count);
+	for (std::size_t i = 0; i < count; i++)
+		CHECK(h->values[i] == 1.5);
+}
+
+TEST_CASE_TEMPLATE("over_aligned-build_unique", H, aligned_head<64>, aligned_head<4096>) {
+	{
+		auto const h = saco::build_unique<H>(10u);
+		check_head(h.get(), 10);
+		CHECK(H::tls_instance_count == 1);
+	}
+	CHECK(H::tls_instance_count == 0);
+
+	auto const h = saco::build_unique_bounded<H>(sizeof(H) + 10 * sizeof(double), 10u);
+	check_head(h.get(), 10);
+}
+
+TEST_CASE_TEMPLATE("over_aligned-build_shared", H, aligned_head<64>, aligned_head<4096>) {
+	{
+		auto const h = saco::build_shared<H>(10u);
+		check_head(h.get(), 10);
+		CHECK(H::tls_instance_count == 1);
+	}
+	CHECK(H::tls_instance_count == 0);
+
+	auto const large = saco::build_shared<H>(1000u);
+	check_head(large.get(), 1000);
+}
+
+TEST_CASE_TEMPLATE("over_aligned-build_with", H, aligned_head<64>, aligned_head<4096>) {
+	std::pmr::unsynchronized_pool_resource resource;
+
+	auto const u = saco::build_unique_with<H>(&resource, 10u);
+	check_head(u.get(), 10);
+	auto const s = saco::build_shared_with<H>(&resource, 10u);
+	check_head(s.get(), 10);
+}
+
+TEST_CASE_TEMPLATE("over_aligned-arena", H, aligned_head<64>, aligned_head<4096>) {
+	{
+		saco::arena a{256};
+		for (std::size_t i = 0; i < 10; i++)
+			check_head(a.build<H>(i), i);
+		CHECK(H::tls_instance_count == 10);
+	}
+	CHECK(H::tls_instance_count == 0);
+}
+
+TEST_CASE("over_aligned-measure_context") {
+	saco::measure_context mctx{64};
+	mctx.allocate_space<aligned_head<64>>();
+	mctx.allocate_space<char>();
+	mctx.allocate_space<aligned_head<64>>();
+	CHECK(mctx.required_size() == 3 * sizeof(aligned_head<64>));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
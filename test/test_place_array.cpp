@@ -0,0 +1,152 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/string.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// array element that places sub-objects of its own
+struct entry {
+	std::string_view name;
+	double* weights;
+};
+
+struct uniform_entry : entry {};
+
+struct table {
+	entry* entries;
+	std::size_t count;
+};
+
+struct uniform_table {
+	uniform_entry* entries;
+	std::size_t count;
+};
+
+template <class Entry, class Context>
+Entry* build_entry(void* memory, Context& ctx, std::string_view name, std::size_t weight_count) {
+	[[maybe_unused]] auto const n = saco::place_string_view(ctx, name);
+	[[maybe_unused]] double* const weights = saco::place_for_overwrite<double[]>(weight_count, ctx);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		for (std::size_t i = 0; i < weight_count; i++)
+			weights[i] = static_cast<double>(i) / 2;
+		Entry* const e = ::new (memory) Entry{};
+		e->name = n;
+		e->weights = weights;
+		return e;
+	} else
+		return nullptr;
+}
+
+template <class Table, class Context>
+Table* build_table(void* memory, Context& ctx, std::size_t count, std::string_view name, std::size_t weight_count) {
+	using Entry = std::remove_pointer_t<decltype(Table::entries)>;
+	[[maybe_unused]] Entry* const entries = saco::place<Entry[]>(count, ctx, name, weight_count);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context)
+		return ::new (memory) Table{entries, count};
+	else
+		return nullptr;
+}
+
+} // namespace
+
+template <>
+struct saco::builder<entry> {
+	template <class Context>
+	static entry* build(void* memory, Context& ctx, std::string_view name, std::size_t weight_count) {
+		return build_entry<entry>(memory, ctx, name, weight_count);
+	}
+};
+
+template <>
+struct saco::builder<uniform_entry> {
+	static constexpr bool uniform_size = true;
+
+	template <class Context>
+	static uniform_entry* build(void* memory, Context& ctx, std::string_view name, std::size_t weight_count) {
+		return build_entry<uniform_entry>(memory, ctx, name, weight_count);
+	}
+};
+
+template <>
+struct saco::builder<table> {
+	template <class Context>
+	static table* build(void* memory, Context& ctx, std::size_t count, std::string_view name, std::size_t weights) {
+		return build_table<table>(memory, ctx, count, name, weights);
+	}
+};
+
+template <>
+struct saco::builder<uniform_table> {
+	template <class Context>
+	static uniform_table* build(
+			void* memory,
+			Context& ctx,
+			std::size_t count,
+			std::string_view name,
+			std::size_t weights) {
+		return build_table<uniform_table>(memory, ctx, count, name, weights);
+	}
+};
+
+static_assert(saco::detail::has_uniform_size_v<int>);
+static_assert(saco::detail::has_uniform_size_v<uniform_entry>);
+static_assert(!saco::detail::has_uniform_size_v<entry>);
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+std::size_t measure(std::size_t count, std::string_view name, std::size_t weights) {
+	saco::measure_context mctx;
+	saco::place<T>(mctx, count, name, weights);
+	return mctx.required_size();
+}
+
+template <class Table>
+void check_table(Table const& t, std::size_t count, std::string_view name, std::size_t weights) {
+	REQUIRE(t.count == count);
+	for (std::size_t i = 0; i < count; i++) {
+		CHECK(t.entries[i].name == name);
+		for (std::size_t w = 0; w < weights; w++)
+			CHECK(t.entries[i].weights[w] == static_cast<double>(w) / 2);
+	}
+}
+
+TEST_CASE("place-array-measures-elements") {
+	for (std::size_t const count : {0, 1, 2, 7, 100})
+		for (std::size_t const name_size : {0, 1, 8, 13})
+			for (std::size_t const weights : {0, 1, 3}) {
+				CAPTURE(count);
+				CAPTURE(name_size);
+				CAPTURE(weights);
+				std::string_view const name = std::string_view{"abcdefghijklmnopqrstuvwxyz"}.substr(0, name_size);
+
+				std::size_t const size = measure<table>(count, name, weights);
+				CHECK(size >= sizeof(table) + count * (sizeof(entry) + name_size + weights * sizeof(double)));
+				CHECK(measure<uniform_table>(count, name, weights) == size);
+
+				// the measured size must be enough to construct the object
+				CHECK_NOTHROW(check_table(*saco::build_unique_bounded<table>(size, count, name, weights), count, name,
+						weights));
+				check_table(*saco::build_unique<uniform_table>(count, name, weights), count, name, weights);
+				check_table(*saco::build_shared<table>(count, name, weights), count, name, weights);
+			}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
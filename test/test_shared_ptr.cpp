@@ -0,0 +1,153 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/shared_ptr.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+std::size_t g_new_count = 0;
+std::size_t g_last_new_size = 0;
+
+} // namespace
+
+// The replacements pair malloc with free. Once they are inlined, GCC only sees free on memory from operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+	g_new_count++;
+	g_last_new_size = size;
+	if (void* const p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct blob {
+	static thread_local int tls_instance_count;
+
+	blob(char* bytes, std::size_t size) : bytes{bytes}, size{size} {
+		tls_instance_count++;
+	}
+
+	~blob() {
+		tls_instance_count--;
+	}
+
+	char* bytes;
+	std::size_t size;
+};
+
+thread_local int blob::tls_instance_count{0};
+
+} // namespace
+
+template <>
+struct saco::builder<blob> {
+	template <class Context>
+	static blob* build(void* memory, Context& ctx, std::size_t size) {
+		[[maybe_unused]] char* const bytes = saco::place<char[]>(size, ctx, 'x');
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) blob{bytes, size};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void check_blob(blob const& b, std::size_t size) {
+	REQUIRE(b.size == size);
+	for (std::size_t i = 0; i < size; i++)
+		REQUIRE(b.bytes[i] == 'x');
+}
+
+TEST_CASE("build_shared-single_allocation") {
+	for (std::size_t const size : {10, 1000, 10000, 100000, 2000000}) {
+		CAPTURE(size);
+		g_new_count = 0;
+		{
+			auto const b = saco::build_shared<blob>(size);
+			CHECK(g_new_count == 1);
+			CHECK(blob::tls_instance_count == 1);
+			check_blob(*b, size);
+		}
+		CHECK(blob::tls_instance_count == 0);
+	}
+}
+
+TEST_CASE("build_shared_exact") {
+	for (std::size_t const size : {0, 1, 10, 1000, 10000, 100000, 2000000}) {
+		CAPTURE(size);
+		g_new_count = 0;
+		{
+			auto const b = saco::build_shared_exact<blob>(size);
+			CHECK(g_new_count == 1);
+			// the control block is followed by exactly the measured size, no bucket slack
+			CHECK(g_last_new_size <= sizeof(blob) + size + 64);
+			CHECK(reinterpret_cast<std::uintptr_t>(b.get()) % saco::detail::MAX_NEW_ALIGNMENT == 0);
+			CHECK(blob::tls_instance_count == 1);
+			check_blob(*b, size);
+		}
+		CHECK(blob::tls_instance_count == 0);
+	}
+}
+
+TEST_CASE("build_shared_exact-control_block") {
+	using buffer = saco::detail::trailing_shared_buffer<saco::detail::MAX_NEW_ALIGNMENT>;
+	using allocator = saco::detail::trailing_storage_allocator<buffer, saco::detail::MAX_NEW_ALIGNMENT>;
+	// besides the reference counts, the control block only holds the destructor thunk
+	CHECK(sizeof(buffer) == sizeof(void (*)(void*)));
+	CHECK(std::is_empty_v<allocator>);
+
+	// the storage is found again from any control block of the same type
+	auto const a = saco::build_shared_exact<blob>(10u);
+	auto const b = saco::build_shared_exact<blob>(1000u);
+	check_blob(*a, 10);
+	check_blob(*b, 1000);
+}
+
+TEST_CASE("build_shared_exact-weak_ptr") {
+	std::weak_ptr<blob> weak;
+	{
+		auto const b = saco::build_shared_exact<blob>(100u);
+		weak = b;
+		CHECK(weak.lock() == b);
+	}
+	// object is destroyed as soon as the last shared_ptr goes away, memory lives until the weak_ptr is gone
+	CHECK(blob::tls_instance_count == 0);
+	CHECK(weak.expired());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
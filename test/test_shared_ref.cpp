@@ -0,0 +1,127 @@
+#include "_common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/shared_ref.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct message {
+	static std::atomic<int> s_instance_count;
+
+	message(char* text, std::size_t size) : text{text}, size{size} {
+		s_instance_count++;
+	}
+
+	~message() {
+		s_instance_count--;
+	}
+
+	std::string_view view() const {
+		return {text, size};
+	}
+
+	char* text;
+	std::size_t size;
+};
+
+std::atomic<int> message::s_instance_count{0};
+
+template <std::size_t ALIGN>
+struct alignas(ALIGN) aligned {
+	int value;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<message> {
+	template <class Context>
+	static message* build(void* memory, Context& ctx, std::string_view sv) {
+		[[maybe_unused]] char* const text = saco::place_for_overwrite<char[]>(sv.size(), ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			sv.copy(text, sv.size());
+			return ::new (memory) message{text, sv.size()};
+		} else
+			return nullptr;
+	}
+};
+
+static_assert(sizeof(saco::shared_ref<message>) == sizeof(void*));
+static_assert(sizeof(saco::local_shared_ref<message>) == sizeof(void*));
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE_TEMPLATE("shared_ref", Counter, saco::atomic_counter, saco::nonatomic_counter) {
+	using ref = saco::shared_ref<message, Counter>;
+
+	{
+		ref const a = saco::build_ref<message, Counter>(std::string_view{"hello world"});
+		CHECK(a);
+		CHECK(a.use_count() == 1);
+		CHECK(a->view() == "hello world");
+		CHECK(message::s_instance_count == 1);
+
+		ref b = a;
+		CHECK(a.use_count() == 2);
+		CHECK(a == b);
+
+		ref c = std::move(b);
+		CHECK(!b);
+		CHECK(b.use_count() == 0);
+		CHECK(c.use_count() == 2);
+
+		c.reset();
+		CHECK(a.use_count() == 1);
+
+		ref d;
+		d = a;
+		d = d;
+		CHECK(a.use_count() == 2);
+		CHECK((*d).view() == "hello world");
+	}
+
+	CHECK(message::s_instance_count == 0);
+}
+
+TEST_CASE("shared_ref-over_aligned") {
+	auto const a = saco::build_local_ref<aligned<64>>(aligned<64>{42});
+	CHECK(reinterpret_cast<std::uintptr_t>(a.get()) % 64 == 0);
+	CHECK(a->value == 42);
+	CHECK(saco::local_shared_ref<aligned<64>>::OBJECT_OFFSET == 64);
+}
+
+TEST_CASE("shared_ref-threads") {
+	{
+		auto const a = saco::build_ref<message>(std::string_view{"shared"});
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++)
+			threads.emplace_back([a] {
+				for (int i = 0; i < 10000; i++) {
+					saco::shared_ref<message> copy = a;
+					REQUIRE(copy->view() == "shared");
+				}
+			});
+		for (auto& t : threads)
+			t.join();
+		CHECK(a.use_count() == 1);
+	}
+
+	CHECK(message::s_instance_count == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,136 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/wait.h>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/shm.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct routes {
+	routes(std::uint32_t* ports, std::size_t count, char const* name, std::size_t name_size) :
+			ports{ports, count},
+			name{name, name_size} {
+	}
+
+	std::string_view get_name() const {
+		return {name.data(), name.size()};
+	}
+
+	saco::offset_span<std::uint32_t> ports;
+	saco::offset_span<char const> name;
+};
+
+} // namespace
+
+template <>
+struct saco::is_relocatable<routes> : std::true_type {};
+
+template <>
+struct saco::builder<routes> {
+	template <class Context>
+	static routes* build(void* memory, Context& ctx, std::size_t count, std::string_view name) {
+		[[maybe_unused]] auto const ports = saco::place_for_overwrite<std::uint32_t[]>(count, ctx);
+		[[maybe_unused]] char* const chars = saco::place_for_overwrite<char[]>(name.size(), ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (std::size_t i = 0; i < count; i++)
+				ports[i] = static_cast<std::uint32_t>(8000 + i);
+			name.copy(chars, name.size());
+			return ::new (memory) routes{ports, count, chars, name.size()};
+		} else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string segment_name(char const* test) {
+	return std::string("/saco_test_") + test + "_" + std::to_string(::getpid());
+}
+
+bool routes_ok(routes const& r, std::size_t count, std::string_view name) {
+	if (r.ports.size() != count || r.get_name() != name)
+		return false;
+	for (std::size_t i = 0; i < count; i++)
+		if (r.ports[i] != 8000 + i)
+			return false;
+	return true;
+}
+
+TEST_CASE("shm-build-attach") {
+	std::string const name = segment_name("build_attach");
+
+	auto const owner = saco::build_shm<routes>(name, std::size_t{500}, std::string_view{"edge"});
+	CHECK(routes_ok(*owner, 500, "edge"));
+
+	auto const reader = saco::attach_shm<routes>(name);
+	CHECK(reader.get() != owner.get());
+	CHECK(reader.size() == owner.size());
+	CHECK(routes_ok(*reader, 500, "edge"));
+
+	// the name is unique
+	CHECK_THROWS_AS(saco::build_shm<routes>(name, std::size_t{1}, std::string_view{"x"}), std::system_error);
+
+	CHECK(saco::unlink_shm(name));
+	CHECK(!saco::unlink_shm(name));
+	CHECK_THROWS_AS(saco::attach_shm<routes>(name), std::system_error);
+
+	// still mapped
+	CHECK(routes_ok(*reader, 500, "edge"));
+}
+
+TEST_CASE("shm-other-process") {
+	std::string const name = segment_name("other_process");
+	auto const owner = saco::build_shm<routes>(name, std::size_t{100}, std::string_view{"core"});
+
+	pid_t const pid = ::fork();
+	REQUIRE(pid >= 0);
+	if (pid == 0) {
+		int status = 1;
+		try {
+			auto const reader = saco::attach_shm<routes>(name);
+			status = routes_ok(*reader, 100, "core") ? 0 : 2;
+		} catch (...) {
+			status = 3;
+		}
+		::_exit(status);
+	}
+
+	int status = 0;
+	REQUIRE(::waitpid(pid, &status, 0) == pid);
+	CHECK(WIFEXITED(status));
+	CHECK(WEXITSTATUS(status) == 0);
+
+	saco::unlink_shm(name);
+}
+
+TEST_CASE("shm-invalid") {
+	std::string const name = segment_name("invalid");
+
+	// a segment that was created but never published
+	int const fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	REQUIRE(fd >= 0);
+	REQUIRE(::ftruncate(fd, 4096) == 0);
+	::close(fd);
+
+	CHECK_THROWS_AS(saco::attach_shm<routes>(name), std::runtime_error);
+	saco::unlink_shm(name);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -1,45 +1,82 @@
-#include "_common.h"
-
-#include <cstddef>
-#include <cstdint>
-
-#include "_poison_std_types_in_global_namespace.h"
-
-#include <saco/xsize_dispatcher.h>
-
-namespace {
-
-struct TestObject {
-	std::size_t bucketSize;
-};
-
-template <std::size_t SIZE>
-struct TestFactoryFn {
-	TestObject operator()() const {
-		return {SIZE};
-	}
-};
-
-template <class Dispatcher>
-void test_size_dispatcher() {
-	static constexpr std::size_t MAX_SIZE = Dispatcher::MAX_SIZE;
-	for (std::size_t size = 1; size < MAX_SIZE; size++) {
-		TestObject const obj = Dispatcher::template dispatch<TestFactoryFn>(size);
-		CHECK(obj.bucketSize >= size);
-		CHECK(obj.bucketSize <= std::max<std::size_t>(64, 2 * size));
-	}
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-TEST_CASE("size_dispatcher_switch") {
-	test_size_dispatcher<saco::detail::size_dispatcher_switch>();
-}
-
-TEST_CASE("size_dispatcher_nested_if") {
-	test_size_dispatcher<saco::detail::size_dispatcher_nested_if>();
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-} // namespace
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/shared_ptr.h>
+#include <saco/xsize_dispatcher.h>
+
+namespace {
+
+struct TestObject {
+	std::size_t bucketSize;
+};
+
+template <std::size_t SIZE>
+struct TestFactoryFn {
+	TestObject operator()() const {
+		return {SIZE};
+	}
+};
+
+template <class Dispatcher>
+void test_size_dispatcher() {
+	static constexpr std::size_t MAX_SIZE = Dispatcher::MAX_SIZE;
+	for (std::size_t size = 1; size < MAX_SIZE; size++) {
+		TestObject const obj = Dispatcher::template dispatch<TestFactoryFn>(size);
+		CHECK(obj.bucketSize >= size);
+		CHECK(obj.bucketSize <= std::max<std::size_t>(64, 2 * size));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("size_dispatcher_switch") {
+	test_size_dispatcher<saco::detail::size_dispatcher_switch>();
+}
+
+TEST_CASE("size_dispatcher_nested_if") {
+	test_size_dispatcher<saco::detail::size_dispatcher_nested_if>();
+}
+
+TEST_CASE("size_dispatcher_geometric") {
+	using dispatcher = saco::detail::size_dispatcher_geometric<std::size_t{1} << 16>;
+	test_size_dispatcher<dispatcher>();
+	CHECK(dispatcher::dispatch<TestFactoryFn>(dispatcher::MAX_SIZE).bucketSize == dispatcher::MAX_SIZE);
+
+	// the small buckets match the ones of the other dispatchers
+	for (std::size_t size = 1; size <= saco::detail::size_dispatcher_switch::MAX_SIZE; size++) {
+		TestObject const obj = dispatcher::dispatch<TestFactoryFn>(size);
+		CHECK(obj.bucketSize == saco::detail::size_dispatcher_switch::dispatch<TestFactoryFn>(size).bucketSize);
+	}
+}
+
+TEST_CASE("size_dispatcher_geometric-large") {
+	using dispatcher = saco::detail::size_dispatcher_geometric<std::size_t{1} << 20>;
+	CHECK(dispatcher::BUCKET_COUNT == 61);
+	for (std::size_t size = 1; size <= dispatcher::MAX_SIZE; size += size / 3 + 1) {
+		TestObject const obj = dispatcher::dispatch<TestFactoryFn>(size);
+		CHECK(obj.bucketSize >= size);
+		CHECK(obj.bucketSize <= std::max<std::size_t>(64, size + size / 2));
+	}
+}
+
+TEST_CASE("size_dispatcher-configured") {
+	using impl = saco::detail::shared_alloc_impl;
+#if SACO_SIZE_DISPATCHER == SACO_SIZE_DISPATCHER_SWITCH
+	CHECK(std::is_same_v<impl::dispatcher, saco::detail::size_dispatcher_switch>);
+#else
+	CHECK(std::is_same_v<impl::dispatcher, saco::detail::size_dispatcher_nested_if>);
+#endif
+
+	// the size classes are the buckets of the configured dispatcher
+	for (std::size_t size = 1; size <= impl::dispatcher::MAX_SIZE; size++)
+		CHECK(impl::size_class(size) == impl::dispatcher::dispatch<TestFactoryFn>(size).bucketSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,246 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct point {
+	explicit point(int v = 0) : x{v}, y{-v} {
+	}
+
+	int x;
+	int y;
+};
+
+struct alignas(64) line {
+	char bytes[64];
+};
+
+struct shape {
+	static thread_local int tls_instance_count;
+
+	shape(point* points, int* ids, line* l) : points{points}, ids{ids}, l{l} {
+		tls_instance_count++;
+	}
+
+	~shape() {
+		tls_instance_count--;
+	}
+
+	point* points;
+	int* ids;
+	line* l;
+};
+
+thread_local int shape::tls_instance_count{0};
+
+struct dynamic_shape : shape {
+	using shape::shape;
+};
+
+// not default-constructible, the static layout must not need the arguments
+struct seed {
+	explicit seed(int v) : value{v} {
+	}
+
+	int value;
+};
+
+struct labeled_shape : shape {
+	labeled_shape(std::string const& label, point* points, int* ids, line* l) : shape{points, ids, l}, label{label} {
+	}
+
+	std::string label;
+};
+
+template <class Context>
+constexpr shape* build_shape(void* memory, Context& ctx, int seed) {
+	[[maybe_unused]] point* const points = saco::place<point[8]>(ctx, seed);
+	[[maybe_unused]] int* const ids = saco::place_for_overwrite<int[3]>(ctx);
+	[[maybe_unused]] line* const l = saco::place_for_overwrite<line>(ctx);
+
+	if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+		for (int i = 0; i < 3; i++)
+			ids[i] = seed + i;
+		return ::new (memory) shape{points, ids, l};
+	} else
+		return nullptr;
+}
+
+} // namespace
+
+template <>
+struct saco::builder<shape> {
+	static constexpr void static_layout(saco::static_measure_context& ctx) {
+		build_shape(nullptr, ctx, 0);
+	}
+
+	template <class Context>
+	static shape* build(void* memory, Context& ctx, int seed) {
+		return build_shape(memory, ctx, seed);
+	}
+};
+
+template <>
+struct saco::builder<dynamic_shape> {
+	template <class Context>
+	static dynamic_shape* build(void* memory, Context& ctx, int seed) {
+		return static_cast<dynamic_shape*>(build_shape(memory, ctx, seed));
+	}
+};
+
+template <>
+struct saco::builder<labeled_shape> {
+	static constexpr void static_layout(saco::static_measure_context& ctx) {
+		build_shape(nullptr, ctx, 0);
+	}
+
+	template <class Context>
+	static labeled_shape* build(void* memory, Context& ctx, std::string const& label, seed s) {
+		point* const points = saco::place<point[8]>(ctx, s.value);
+		int* const ids = saco::place_for_overwrite<int[3]>(ctx);
+		line* const l = saco::place_for_overwrite<line>(ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context) {
+			for (int i = 0; i < 3; i++)
+				ids[i] = s.value + i;
+			return ::new (memory) labeled_shape{label, points, ids, l};
+		} else
+			return nullptr;
+	}
+};
+
+static_assert(saco::detail::has_static_layout_v<shape>);
+static_assert(saco::detail::has_static_layout_v<labeled_shape>);
+static_assert(!saco::detail::has_static_layout_v<dynamic_shape>);
+static_assert(!saco::detail::has_static_layout_v<point>);
+
+// the size is a constant expression
+static_assert(saco::detail::static_size_v<shape> >= sizeof(shape) + 8 * sizeof(point) + 3 * sizeof(int) + 64);
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void check_shape(shape const& s, int seed) {
+	for (int i = 0; i < 8; i++) {
+		CHECK(s.points[i].x == seed);
+		CHECK(s.points[i].y == -seed);
+	}
+	for (int i = 0; i < 3; i++)
+		CHECK(s.ids[i] == seed + i);
+	CHECK(reinterpret_cast<std::uintptr_t>(s.l) % 64 == 0);
+}
+
+TEST_CASE("static_size-matches-measure_context") {
+	saco::measure_context mctx{saco::detail::root_alignment_v<shape>};
+	saco::place<dynamic_shape>(mctx, 1);
+	CHECK(saco::detail::static_size_v<shape> == mctx.required_size());
+}
+
+TEST_CASE("static_measure_context-over-aligned") {
+	constexpr std::size_t size = [] {
+		saco::static_measure_context mctx{saco::detail::MAX_NEW_ALIGNMENT};
+		mctx.allocate_space<char>(3);
+		mctx.allocate_space<line>(2);
+		mctx.allocate_space<double>();
+		return mctx.required_size();
+	}();
+
+	saco::measure_context mctx;
+	mctx.allocate_space<char>(3);
+	mctx.allocate_space<line>(2);
+	mctx.allocate_space<double>();
+	CHECK(size == mctx.required_size());
+}
+
+TEST_CASE("static_measure_context-measure_repeated") {
+	constexpr std::size_t size = [] {
+		saco::static_measure_context mctx{saco::detail::MAX_NEW_ALIGNMENT};
+		mctx.allocate_space<char>();
+		mctx.measure_repeated(5, [&] {
+			mctx.allocate_space<line>();
+			mctx.allocate_space<char>(3);
+		});
+		return mctx.required_size();
+	}();
+
+	saco::measure_context mctx;
+	mctx.allocate_space<char>();
+	mctx.measure_repeated(5, [&] {
+		mctx.allocate_space<line>();
+		mctx.allocate_space<char>(3);
+	});
+	CHECK(size == mctx.required_size());
+}
+
+TEST_CASE("static_measure_context-cold") {
+	constexpr std::size_t size = [] {
+		saco::static_measure_context mctx{saco::detail::MAX_NEW_ALIGNMENT};
+		mctx.allocate_space<char>(3);
+		mctx.measure_repeated(3, [&] {
+			mctx.allocate_space<int>();
+			mctx.allocate_cold_space<double>(2);
+		});
+		mctx.allocate_cold_space<char>(5);
+		return mctx.required_size();
+	}();
+
+	saco::measure_context mctx;
+	mctx.allocate_space<char>(3);
+	mctx.measure_repeated(3, [&] {
+		mctx.allocate_space<int>();
+		mctx.allocate_cold_space<double>(2);
+	});
+	mctx.allocate_cold_space<char>(5);
+	CHECK(size == mctx.required_size());
+}
+
+TEST_CASE("static_layout-build_unique") {
+	{
+		auto const s = saco::build_unique<shape>(5);
+		CHECK(shape::tls_instance_count == 1);
+		check_shape(*s, 5);
+
+		auto const d = saco::build_unique<dynamic_shape>(6);
+		check_shape(*d, 6);
+	}
+	CHECK(shape::tls_instance_count == 0);
+}
+
+TEST_CASE("static_layout-build_shared") {
+	{
+		std::shared_ptr<shape> const s = saco::build_shared<shape>(7);
+		CHECK(shape::tls_instance_count == 1);
+		check_shape(*s, 7);
+	}
+	CHECK(shape::tls_instance_count == 0);
+}
+
+TEST_CASE("static_layout-non_literal_arguments") {
+	{
+		std::string const label = "a label too long for the small string buffer";
+		auto const u = saco::build_unique<labeled_shape>(label, seed{8});
+		check_shape(*u, 8);
+		CHECK(u->label == label);
+
+		std::shared_ptr<labeled_shape> const s = saco::build_shared<labeled_shape>(label, seed{9});
+		check_shape(*s, 9);
+		CHECK(s->label == label);
+	}
+	CHECK(shape::tls_instance_count == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,154 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/allocator.h>
+#include <saco/saco.h>
+#include <saco/shared_ptr.h>
+#include <saco/stats.h>
+
+#if !defined(SACO_STATS)
+#error "test_stats must be built with SACO_STATS"
+#endif
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct padded {
+	char* tag;
+	std::uint64_t* values;
+	std::size_t count;
+};
+
+struct fixed {
+	std::uint32_t values[3];
+	char name[5];
+};
+
+} // namespace
+
+template <>
+struct saco::builder<padded> {
+	template <class Context>
+	static padded* build(void* memory, Context& ctx, std::size_t count) {
+		// the tag leaves a gap before the values
+		[[maybe_unused]] char* const tag = saco::place_for_overwrite<char[]>(1, ctx);
+		[[maybe_unused]] std::uint64_t* const values = saco::place_for_overwrite<std::uint64_t[]>(count, ctx);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) padded{tag, values, count};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::size_t measure_padded(std::size_t count) {
+	saco::measure_context mctx;
+	saco::place<padded>(mctx, count);
+	return mctx.required_size();
+}
+
+TEST_CASE("measure_context-padding_size") {
+	saco::measure_context mctx;
+	saco::place<padded>(mctx, 4u);
+	CHECK(mctx.padding_size() == mctx.required_size() - sizeof(padded) - 1 - 4 * sizeof(std::uint64_t));
+	CHECK(mctx.padding_size() == sizeof(std::uint64_t) - 1);
+
+	// arrays of measured elements count their padding, too
+	saco::measure_context array;
+	saco::place<padded[]>(3, array, 4u);
+	std::size_t const payload = 3 * (sizeof(padded) + 1 + 4 * sizeof(std::uint64_t));
+	CHECK(array.padding_size() == array.required_size() - payload);
+	CHECK(array.padding_size() > 0);
+
+	// multiplied measurements as well
+	saco::measure_context repeated;
+	saco::place_for_overwrite<std::uint64_t[]>(1, repeated);
+	repeated.measure_repeated(5, [&] { saco::place<padded>(repeated, 4u); });
+	CHECK(repeated.padding_size() == repeated.required_size() - 8 - 5 * (sizeof(padded) + 1 + 32));
+	CHECK(repeated.padding_size() == 5 * (sizeof(std::uint64_t) - 1));
+}
+
+TEST_CASE("stats-build_unique") {
+	saco::reset_stats();
+	CHECK(saco::STATS_ENABLED);
+
+	auto const a = saco::build_unique<padded>(4u);
+	auto const b = saco::build_unique<padded>(10u);
+	auto const c = saco::build_unique_bounded<padded>(1000, 2u);
+
+	saco::build_stats const stats = saco::stats<padded>();
+	CHECK(stats.builds == 3);
+	CHECK(stats.block_bytes == measure_padded(4) + measure_padded(10) + 1000);
+	CHECK(stats.padding_bytes == 2 * (sizeof(std::uint64_t) - 1));
+	CHECK(stats.slack_bytes() == 0);
+	CHECK(saco::stats<fixed>().builds == 0);
+}
+
+TEST_CASE("stats-build_shared") {
+	saco::reset_stats();
+
+	for (std::size_t count = 0; count < 50; count++) {
+		std::shared_ptr<padded> const p = saco::build_shared<padded>(count);
+		saco::build_stats const stats = saco::stats<padded>();
+		CHECK(stats.builds == count + 1);
+		CHECK(stats.allocated_bytes >= stats.block_bytes);
+	}
+
+	// sizes are rounded up to size classes, the slack is what that costs
+	saco::build_stats const stats = saco::stats<padded>();
+	std::size_t slack = 0;
+	for (std::size_t count = 0; count < 50; count++) {
+		std::size_t const size = measure_padded(count);
+		slack += saco::detail::shared_alloc_impl::size_class(size) - size;
+	}
+	CHECK(stats.slack_bytes() == slack);
+
+	saco::build_shared_exact<padded>(7u);
+	CHECK(saco::stats<padded>().slack_bytes() == slack);
+}
+
+TEST_CASE("stats-snapshot") {
+	saco::reset_stats();
+
+	saco::build_unique<fixed>();
+	saco::build_shared<fixed>();
+	saco::build_unique_with<padded>(std::allocator<saco::byte>{}, 1u);
+
+	bool found_fixed = false;
+	bool found_padded = false;
+	saco::build_stats total;
+	for (saco::type_build_stats const& entry : saco::stats_snapshot()) {
+		REQUIRE(entry.type_name != nullptr);
+		total += entry.stats;
+		if (std::strcmp(entry.type_name, typeid(fixed).name()) == 0) {
+			found_fixed = true;
+			CHECK(entry.stats.builds == 2);
+			CHECK(entry.stats.block_bytes == 2 * sizeof(fixed));
+		}
+		if (std::strcmp(entry.type_name, typeid(padded).name()) == 0) {
+			found_padded = true;
+			CHECK(entry.stats.builds == 1);
+		}
+	}
+	CHECK(found_fixed);
+	CHECK(found_padded);
+	CHECK(total.builds == 3);
+
+	saco::reset_stats();
+	CHECK(saco::stats<fixed>().builds == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
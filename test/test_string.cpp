@@ -0,0 +1,105 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/saco.h>
+#include <saco/string.h>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct strings {
+	std::string_view view;
+	char const* c_str;
+	saco::inline_string key;
+	saco::inline_wstring wide;
+};
+
+} // namespace
+
+template <>
+struct saco::builder<strings> {
+	template <class Context>
+	static strings* build(void* memory, Context& ctx, std::string const& str, wchar_t const* wide) {
+		[[maybe_unused]] auto const view = saco::place_string_view(ctx, str);
+		[[maybe_unused]] auto const c_str = saco::place_c_str(ctx, str);
+		[[maybe_unused]] auto const key = saco::place_inline_string(ctx, std::string_view{str});
+		[[maybe_unused]] auto const w = saco::place_inline_string(ctx, wide);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) strings{view, c_str, key, w};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static_assert(sizeof(saco::inline_string) == sizeof(char const*));
+
+std::size_t measure_inline_string(std::size_t length) {
+	std::string const str(length, 'x');
+	saco::measure_context mctx;
+	saco::place_inline_string(mctx, std::string_view{str});
+	return mctx.required_size();
+}
+
+TEST_CASE("string-placement") {
+	for (std::size_t const length : {0, 1, 15, 127, 128, 1000, 20000}) {
+		CAPTURE(length);
+		std::string str;
+		for (std::size_t i = 0; i < length; i++)
+			str.push_back(static_cast<char>('a' + i % 26));
+
+		auto const s = saco::build_unique<strings>(str, L"wide");
+		CHECK(s->view == str);
+		CHECK(s->c_str == str);
+		CHECK(s->key.view() == str);
+		CHECK(s->key.size() == length);
+		CHECK(s->key.empty() == str.empty());
+		CHECK(std::string(s->key.begin(), s->key.end()) == str);
+		CHECK(s->wide.view() == L"wide");
+		CHECK(reinterpret_cast<std::uintptr_t>(s->wide.data()) % alignof(wchar_t) == 0);
+	}
+}
+
+TEST_CASE("inline_string-overhead") {
+	CHECK(measure_inline_string(0) == 0);
+	CHECK(measure_inline_string(1) == 2);
+	CHECK(measure_inline_string(127) == 128);
+	CHECK(measure_inline_string(128) == 130);
+	CHECK(measure_inline_string(16383) == 16385);
+	CHECK(measure_inline_string(16384) == 16387);
+}
+
+TEST_CASE("inline_string-compare") {
+	auto const a = saco::build_unique<strings>(std::string("abc"), L"");
+	auto const b = saco::build_unique<strings>(std::string("abc"), L"");
+	auto const c = saco::build_unique<strings>(std::string("abd"), L"");
+	CHECK(a->key == b->key);
+	CHECK(a->key != c->key);
+	CHECK(a->wide.empty());
+	CHECK(a->wide == saco::inline_wstring{});
+}
+
+TEST_CASE("varint") {
+	for (std::size_t const value : {std::size_t{0}, std::size_t{127}, std::size_t{128}, std::size_t{1} << 40}) {
+		unsigned char buffer[16];
+		std::size_t const n = saco::detail::varint_size(value);
+		saco::detail::write_reverse_varint(buffer + sizeof(buffer), value);
+		CHECK(saco::detail::read_reverse_varint(buffer + sizeof(buffer)) == value);
+		CHECK((buffer[sizeof(buffer) - n] & 0x80) == 0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace
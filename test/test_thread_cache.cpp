@@ -0,0 +1,180 @@
+#include "_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "_poison_std_types_in_global_namespace.h"
+
+#include <saco/thread_cache.h>
+
+#if !SACO_SHARED_THREAD_CACHE
+#error "test_thread_cache must be built with SACO_SHARED_THREAD_CACHE=1"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+std::size_t g_new_count = 0;
+std::size_t g_delete_count = 0;
+
+} // namespace
+
+// The replacements pair malloc with free. Once they are inlined, GCC only sees free on memory from operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+	g_new_count++;
+	if (void* const p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	if (p)
+		g_delete_count++;
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	::operator delete(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct item {
+	static thread_local int tls_instance_count;
+
+	item(int* values, std::size_t count) : values{values}, count{count} {
+		tls_instance_count++;
+	}
+
+	~item() {
+		tls_instance_count--;
+	}
+
+	int* values;
+	std::size_t count;
+};
+
+thread_local int item::tls_instance_count{0};
+
+} // namespace
+
+template <>
+struct saco::builder<item> {
+	template <class Context>
+	static item* build(void* memory, Context& ctx, std::size_t count) {
+		[[maybe_unused]] int* const values = saco::place<int[]>(count, ctx, 7);
+
+		if SACO_IF_CONSTRUCT_CONTEXT (Context)
+			return ::new (memory) item{values, count};
+		else
+			return nullptr;
+	}
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("thread_cache-buckets") {
+	using cache = saco::detail::thread_cache;
+	CHECK(cache::BUCKET_COUNT == 25);
+	CHECK(cache::buckets::bucket_size(0) == 32);
+	CHECK(cache::buckets::bucket_size(cache::BUCKET_COUNT - 1) == cache::MAX_SIZE);
+	CHECK(cache::max_count(0) == SACO_THREAD_CACHE_BYTES_PER_BUCKET / 32);
+}
+
+TEST_CASE("build_unique_cached-recycles_blocks") {
+	std::thread([] {
+		std::vector<saco::cached_unique_ptr<item>> items;
+
+		// warm up the cache
+		for (std::size_t i = 0; i < 10; i++)
+			items.push_back(saco::build_unique_cached<item>(i));
+		items.clear();
+		CHECK(saco::detail::thread_cache::cached_blocks() > 0);
+
+		std::size_t const new_count = g_new_count;
+		std::size_t const delete_count = g_delete_count;
+		for (int round = 0; round < 100; round++) {
+			for (std::size_t i = 0; i < 10; i++)
+				items.push_back(saco::build_unique_cached<item>(i));
+			for (std::size_t i = 0; i < 10; i++) {
+				REQUIRE(items[i]->count == i);
+				for (std::size_t j = 0; j < i; j++)
+					REQUIRE(items[i]->values[j] == 7);
+			}
+			items.clear();
+		}
+		CHECK(g_new_count == new_count);
+		CHECK(g_delete_count == delete_count);
+		CHECK(item::tls_instance_count == 0);
+	}).join();
+}
+
+TEST_CASE("build_shared_cached-recycles_blocks") {
+	std::thread([] {
+		saco::build_shared_cached<item>(5u).reset();
+
+		std::size_t const new_count = g_new_count;
+		for (int round = 0; round < 100; round++) {
+			auto const sp = saco::build_shared_cached<item>(5u);
+			REQUIRE(sp->count == 5);
+		}
+		CHECK(g_new_count == new_count);
+		CHECK(item::tls_instance_count == 0);
+	}).join();
+}
+
+TEST_CASE("build_shared-recycles_blocks") {
+	std::thread([] {
+		saco::build_shared<item>(5u).reset();
+
+		std::size_t const new_count = g_new_count;
+		for (int round = 0; round < 100; round++) {
+			auto const sp = saco::build_shared<item>(5u);
+			REQUIRE(sp->count == 5);
+		}
+		CHECK(g_new_count == new_count);
+		CHECK(item::tls_instance_count == 0);
+	}).join();
+}
+
+TEST_CASE("thread_cache-flushed_on_thread_exit") {
+	std::size_t const new_count = g_new_count;
+	std::size_t const delete_count = g_delete_count;
+
+	std::thread([] {
+		std::vector<saco::cached_unique_ptr<item>> items;
+		for (std::size_t i = 0; i < 100; i++)
+			items.push_back(saco::build_unique_cached<item>(i));
+	}).join();
+
+	// every block that was allocated by the thread was released when it exited
+	CHECK(g_new_count - new_count == g_delete_count - delete_count);
+}
+
+TEST_CASE("thread_cache-large_blocks") {
+	auto const a = saco::build_unique_cached<item>(10000u);
+	CHECK(a->count == 10000);
+	CHECK(a->values[9999] == 7);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace